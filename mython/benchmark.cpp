@@ -0,0 +1,274 @@
+#include "bytecode.h"
+#include "lexer.h"
+#include "log_duration.h"
+#include "parse.h"
+#include "program_cache.h"
+#include "runtime.h"
+#include "scan.h"
+#include "statement.h"
+#include "superinstructions.h"
+
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace std;
+
+namespace bench {
+
+    namespace {
+
+        unique_ptr<runtime::Executable> ParseProgramFromString(const string& program) {
+            istringstream is(program);
+            parse::Lexer lexer(is);
+            return ParseProgram(lexer);
+        }
+
+        //      ,    -   
+        void Measure(const string& name, const string& program, int runs, ostream& out) {
+            {
+                auto tree = ParseProgramFromString(program);
+                LOG_DURATION_STREAM(name + " [ast]"s, out);
+                for (int i = 0; i < runs; ++i) {
+                    runtime::DummyContext context;
+                    runtime::Closure closure;
+                    tree->Execute(closure, context);
+                }
+            }
+            {
+                auto fused = ast::FuseSuperinstructions(ParseProgramFromString(program));
+                LOG_DURATION_STREAM(name + " [ast, superinstructions]"s, out);
+                for (int i = 0; i < runs; ++i) {
+                    runtime::DummyContext context;
+                    runtime::Closure closure;
+                    fused->Execute(closure, context);
+                }
+            }
+            {
+                auto compiled = bytecode::Compile(ParseProgramFromString(program));
+                LOG_DURATION_STREAM(name + " [bytecode]"s, out);
+                for (int i = 0; i < runs; ++i) {
+                    runtime::DummyContext context;
+                    runtime::Closure closure;
+                    compiled->Execute(closure, context);
+                }
+            }
+        }
+
+        void BenchDeepRecursion(ostream& out) {
+            const string program = R"(
+class Counter:
+  def down(n):
+    if n > 0:
+      return self.down(n - 1) + 1
+    return 0
+
+  def fib(n):
+    if n < 2:
+      return n
+    return self.fib(n - 1) + self.fib(n - 2)
+
+counter = Counter()
+depth = counter.down(2000)
+fib = counter.fib(20)
+)"s;
+            Measure("Deep recursion, 20 runs"s, program, 20, out);
+        }
+
+        //        
+        void BenchFieldAccess(ostream& out) {
+            const string program = R"(
+class Accumulator:
+  def __init__():
+    self.count = 0
+    self.sum = 0
+    self.last = 0
+
+  def run(n):
+    if n > 0:
+      self.count = self.count + 1
+      self.sum = self.sum + n
+      self.last = n
+      return self.run(n - 1)
+    return self.sum
+
+acc = Accumulator()
+total = acc.run(2000)
+)"s;
+            Measure("Field access, 20 runs"s, program, 20, out);
+        }
+
+        //       
+        void BenchInstanceAllocation(ostream& out) {
+            const string program = R"(
+class Node:
+  def __init__(value, next):
+    self.value = value
+    self.next = next
+
+class Builder:
+  def build(n, tail):
+    if n > 0:
+      return self.build(n - 1, Node(n, tail))
+    return tail
+
+  def churn(rounds):
+    if rounds > 0:
+      list = self.build(1000, None)
+      self.churn(rounds - 1)
+
+builder = Builder()
+builder.churn(50)
+)"s;
+            Measure("Instance allocation, 50k objects x 10 runs"s, program, 10, out);
+        }
+
+        //         
+        void BenchComparisonAndArithmetic(ostream& out) {
+            const vector<runtime::ObjectHolder> values = {
+                runtime::ObjectHolder::Own(runtime::Number(1)),
+                runtime::ObjectHolder::Own(runtime::Number(2)),
+                runtime::ObjectHolder::Own(runtime::String("abc"s)),
+                runtime::ObjectHolder::Own(runtime::String("abd"s)),
+                runtime::ObjectHolder::Own(runtime::Bool(true)),
+                runtime::ObjectHolder::Own(runtime::Bool(false)),
+            };
+            const int iterations = 2'000'000;
+            runtime::DummyContext context;
+
+            size_t true_count = 0;
+            {
+                LOG_DURATION_STREAM("Equal/Less/IsTrue, "s + to_string(iterations) + " iterations"s, out);
+                for (int i = 0; i < iterations; ++i) {
+                    const auto& lhs = values[i % values.size()];
+                    const auto& rhs = values[(i % values.size()) ^ 1];
+                    true_count += runtime::Equal(lhs, rhs, context);
+                    true_count += runtime::Less(lhs, rhs, context);
+                    true_count += runtime::IsTrue(lhs);
+                }
+            }
+            {
+                LOG_DURATION_STREAM("Add/Sub/Mult on numbers, "s + to_string(iterations) + " iterations"s, out);
+                for (int i = 0; i < iterations; ++i) {
+                    auto sum = runtime::Add(values[0], values[1], context);
+                    auto diff = runtime::Sub(sum, values[1]);
+                    true_count += runtime::IsTrue(runtime::Mult(diff, values[1]));
+                }
+            }
+            out << "(checksum "s << true_count << ')' << endl;
+        }
+
+        //      size :  ,
+        //  ,    
+        string MakeLexerInput(size_t size) {
+            string result;
+            result.reserve(size + 1024);
+            for (int i = 0; result.size() < size; ++i) {
+                const string suffix = to_string(i % 100);
+                //   ,       
+                result += "class GeometryShapeWithLongName"s + to_string(i) + ":\n"s;
+                result += "  def compute_bounding_box_area_"s + suffix + "(first_argument_value, second_argument_value):\n"s;
+                result += "    if first_argument_value >= second_argument_value and not first_argument_value == 0:"s
+                    "  #      ,   \n"s;
+                result += "      accumulated_result_value = first_argument_value * second_argument_value + 12345\n"s;
+                result += "      return accumulated_result_value\n"s;
+                result += "    return 'the second argument is greater than the first one'\n"s;
+                result += "\n"s;
+            }
+            return result;
+        }
+
+        //       ,  
+        void BenchLexerThroughput(ostream& out) {
+            const string input = MakeLexerInput(16 << 20);
+            const double megabytes = static_cast<double>(input.size()) / (1 << 20);
+            const parse::scan::Isa initial_isa = parse::scan::GetIsa();
+            for (const auto isa : { parse::scan::Isa::Scalar, parse::scan::Isa::Sse2, parse::scan::Isa::Avx2 }) {
+                if (!parse::scan::SetIsa(isa)) {
+                    continue;
+                }
+                size_t token_count = 0;
+                const auto start = chrono::steady_clock::now();
+                parse::Lexer lexer(string_view{ input });
+                while (!lexer.CurrentToken().Is<parse::token_type::Eof>()) {
+                    lexer.NextToken();
+                    ++token_count;
+                }
+                const chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+                out << "Lexer throughput ["s << parse::scan::GetIsaName(isa) << "]: "s
+                    << static_cast<int>(megabytes / seconds.count()) << " MB/s ("s
+                    << static_cast<int>(megabytes) << " MB, "s << token_count << " tokens)"s << endl;
+            }
+            parse::scan::SetIsa(initial_isa);
+        }
+
+        //     ,   ,  .
+        //  false,    
+        bool PinToOneCore() {
+#ifdef __linux__
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(sched_getcpu(), &cpus);
+            return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+            return false;
+#endif
+        }
+
+        //       : ,
+        //           ,     ,
+        //          
+        void BenchFrontEnd(ostream& out) {
+            const string input = MakeLexerInput(8 << 20);
+            const string size = to_string(input.size() >> 20) + " MB"s;
+            const auto parse = [&input](parse::Lexer::Mode mode) {
+                parse::Lexer lexer(string_view{ input }, mode);
+                return ParseProgram(lexer);
+            };
+            const unsigned cores = thread::hardware_concurrency();
+            {
+                LOG_DURATION_STREAM("Front end, "s + size + ", sequential"s, out);
+                parse(parse::Lexer::Mode::OnDemand);
+            }
+            {
+                LOG_DURATION_STREAM("Front end, "s + size + ", pipelined, "s + to_string(cores) + (cores == 1 ? " core"s : " cores"s), out);
+                parse(parse::Lexer::Mode::Pipelined);
+            }
+            for (const size_t threads : { 2U, 4U }) {
+                LOG_DURATION_STREAM("Front end, "s + size + ", parallel parse, "s + to_string(threads) + " threads"s, out);
+                ParseProgramParallel(input, threads);
+            }
+            {
+                const string data = cache::Serialize(*parse(parse::Lexer::Mode::OnDemand));
+                LOG_DURATION_STREAM("Front end, "s + size + ", load from cache"s, out);
+                cache::Deserialize(data);
+            }
+#ifdef __linux__
+            cpu_set_t all_cpus;
+            if (cores > 1 && sched_getaffinity(0, sizeof(all_cpus), &all_cpus) == 0 && PinToOneCore()) {
+                {
+                    LOG_DURATION_STREAM("Front end, "s + size + ", pipelined, 1 core"s, out);
+                    parse(parse::Lexer::Mode::Pipelined);
+                }
+                sched_setaffinity(0, sizeof(all_cpus), &all_cpus);
+            }
+#endif
+        }
+
+    }  // namespace
+
+    void RunBenchmarks(ostream& out) {
+        BenchDeepRecursion(out);
+        BenchFieldAccess(out);
+        BenchInstanceAllocation(out);
+        BenchComparisonAndArithmetic(out);
+        BenchLexerThroughput(out);
+        BenchFrontEnd(out);
+    }
+
+}  // namespace bench
@@ -0,0 +1,668 @@
+#include "bytecode.h"
+
+#include "statement.h"
+
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+
+namespace bytecode {
+
+    using runtime::Closure;
+    using runtime::Context;
+    using runtime::ObjectHolder;
+
+    namespace {
+        //       
+        int StackEffect(const Instruction& instr) {
+            switch (instr.op) {
+            case OpCode::LoadConst:
+            case OpCode::LoadNone:
+            case OpCode::LoadName:
+            case OpCode::LoadLocal:
+            case OpCode::ExecuteNode:
+            case OpCode::PrintNewline:
+                return 1;
+            case OpCode::StoreField:
+            case OpCode::Add:
+            case OpCode::Sub:
+            case OpCode::Mult:
+            case OpCode::Div:
+            case OpCode::Equal:
+            case OpCode::NotEqual:
+            case OpCode::Less:
+            case OpCode::Greater:
+            case OpCode::LessOrEqual:
+            case OpCode::GreaterOrEqual:
+            case OpCode::JumpIfFalse:
+            case OpCode::JumpIfTrue:
+            case OpCode::Print:
+            case OpCode::Pop:
+            case OpCode::Return:
+                return -1;
+            case OpCode::CallMethod:
+                return -static_cast<int>(instr.arg_count);
+            case OpCode::NewInstance:
+                return 1 - static_cast<int>(instr.arg_count);
+            default:
+                return 0;
+            }
+        }
+    }  // namespace
+
+    //      .   Mython 
+    //  ,      
+    class Compiler {
+    public:
+        Compiler(Chunk& chunk, MethodTable& methods)
+            : chunk_(chunk)
+            , methods_(methods) {
+            chunk_.methods = &methods_;
+        }
+
+        void CompileStatement(runtime::Executable& node) {
+            if (auto* p = dynamic_cast<ast::NumericConst*>(&node)) {
+                EmitConstant(ObjectHolder::Own(runtime::Number(p->GetValue().GetValue())));
+            }
+            else if (auto* p = dynamic_cast<ast::StringConst*>(&node)) {
+                EmitConstant(ObjectHolder::Own(runtime::String(p->GetValue().GetValue())));
+            }
+            else if (auto* p = dynamic_cast<ast::BoolConst*>(&node)) {
+                EmitConstant(ObjectHolder::Own(runtime::Bool(p->GetValue().GetValue())));
+            }
+            else if (dynamic_cast<ast::None*>(&node)) {
+                Emit(OpCode::LoadNone);
+            }
+            else if (auto* p = dynamic_cast<ast::VariableValue*>(&node)) {
+                CompileVariable(*p);
+            }
+            else if (auto* p = dynamic_cast<ast::Assignment*>(&node)) {
+                CompileStatement(p->GetValue());
+                if (p->GetSlot() != ast::NO_SLOT) {
+                    Emit(OpCode::StoreLocal, SlotOperand(p->GetSlot()));
+                }
+                else {
+                    Emit(OpCode::StoreName, AddName(p->GetName()));
+                }
+            }
+            else if (auto* p = dynamic_cast<ast::FieldAssignment*>(&node)) {
+                CompileVariable(p->GetObject());
+                CompileStatement(p->GetValue());
+                Emit(OpCode::StoreField, AddFieldSite(p->GetFieldName()));
+            }
+            else if (auto* p = dynamic_cast<ast::Print*>(&node)) {
+                //     ,      
+                for (size_t i = 0; i < p->GetArgs().size(); ++i) {
+                    CompileStatement(*p->GetArgs()[i]);
+                    Emit(OpCode::Print, static_cast<uint32_t>(i));
+                }
+                Emit(OpCode::PrintNewline);
+            }
+            else if (auto* p = dynamic_cast<ast::MethodCall*>(&node)) {
+                CompileMethodCall(*p);
+            }
+            else if (auto* p = dynamic_cast<ast::NewInstance*>(&node)) {
+                CompileNewInstance(*p);
+            }
+            else if (auto* p = dynamic_cast<ast::Stringify*>(&node)) {
+                CompileStatement(p->GetArgument());
+                Emit(OpCode::Stringify);
+            }
+            else if (auto* p = dynamic_cast<ast::Not*>(&node)) {
+                CompileStatement(p->GetArgument());
+                Emit(OpCode::Not);
+            }
+            else if (auto* p = dynamic_cast<ast::Add*>(&node)) {
+                CompileBinary(*p, OpCode::Add);
+            }
+            else if (auto* p = dynamic_cast<ast::Sub*>(&node)) {
+                CompileBinary(*p, OpCode::Sub);
+            }
+            else if (auto* p = dynamic_cast<ast::Mult*>(&node)) {
+                CompileBinary(*p, OpCode::Mult);
+            }
+            else if (auto* p = dynamic_cast<ast::Div*>(&node)) {
+                CompileBinary(*p, OpCode::Div);
+            }
+            else if (auto* p = dynamic_cast<ast::Or*>(&node)) {
+                CompileLogical(*p, OpCode::JumpIfTrue);
+            }
+            else if (auto* p = dynamic_cast<ast::And*>(&node)) {
+                CompileLogical(*p, OpCode::JumpIfFalse);
+            }
+            else if (auto* p = dynamic_cast<ast::BuiltinComparison*>(&node)) {
+                CompileComparison(*p);
+            }
+            else if (auto* p = dynamic_cast<ast::Compound*>(&node)) {
+                for (const auto& arg : p->GetStatements()) {
+                    CompileStatement(*arg);
+                    Emit(OpCode::Pop);
+                }
+                Emit(OpCode::LoadNone);
+            }
+            else if (auto* p = dynamic_cast<ast::IfElse*>(&node)) {
+                CompileIfElse(*p);
+            }
+            else if (auto* p = dynamic_cast<ast::Return*>(&node)) {
+                CompileStatement(p->GetStatement());
+                Emit(OpCode::Return);
+                //   Return ,    ,     
+                ++depth_;
+            }
+            else if (auto* p = dynamic_cast<ast::MethodBody*>(&node)) {
+                CompileStatement(p->GetBody());
+                Emit(OpCode::Pop);
+                Emit(OpCode::LoadNone);
+            }
+            else if (auto* p = dynamic_cast<ast::ClassDefinition*>(&node)) {
+                auto* cls = p->GetClass().TryAs<runtime::Class>();
+                CompileMethods(*cls);
+                EmitConstant(p->GetClass());
+                Emit(OpCode::StoreName, AddName(cls->GetName()));
+                Emit(OpCode::Pop);
+                Emit(OpCode::LoadNone);
+            }
+            else {
+                EmitNode(node);
+            }
+        }
+
+        void Finish() {
+            Emit(OpCode::Return);
+        }
+
+        //        
+        void CompileMethods(const runtime::Class& cls) {
+            for (const runtime::Method& method : cls.GetOwnMethods()) {
+                if (methods_.count(&method) != 0) {
+                    continue;
+                }
+                Chunk chunk;
+                Compiler compiler(chunk, methods_);
+                compiler.CompileStatement(*method.body);
+                compiler.Finish();
+                methods_.emplace(&method, make_unique<Function>(nullptr, std::move(chunk)));
+            }
+        }
+
+    private:
+        size_t Emit(OpCode op, uint32_t operand = 0, uint16_t arg_count = 0) {
+            Instruction instr{ op, arg_count, operand };
+            chunk_.code.push_back(instr);
+            depth_ += StackEffect(instr);
+            chunk_.max_stack = max(chunk_.max_stack, static_cast<size_t>(max(depth_, 0)));
+            return chunk_.code.size() - 1;
+        }
+
+        void PatchJump(size_t jump) {
+            chunk_.code[jump].operand = static_cast<uint32_t>(chunk_.code.size());
+        }
+
+        void EmitConstant(ObjectHolder value) {
+            chunk_.constants.push_back(std::move(value));
+            Emit(OpCode::LoadConst, static_cast<uint32_t>(chunk_.constants.size() - 1));
+        }
+
+        void EmitNode(runtime::Executable& node) {
+            chunk_.nodes.push_back(&node);
+            Emit(OpCode::ExecuteNode, static_cast<uint32_t>(chunk_.nodes.size() - 1));
+        }
+
+        uint32_t AddName(runtime::Symbol name) {
+            auto [it, inserted] = name_indices_.emplace(name, static_cast<uint32_t>(chunk_.names.size()));
+            if (inserted) {
+                chunk_.names.push_back(name);
+            }
+            return it->second;
+        }
+
+        uint32_t AddFieldSite(runtime::Symbol name) {
+            chunk_.field_sites.push_back({ AddName(name), {} });
+            return static_cast<uint32_t>(chunk_.field_sites.size() - 1);
+        }
+
+        static uint16_t ArgCount(size_t count) {
+            if (count > numeric_limits<uint16_t>::max()) {
+                throw runtime_error("Too many arguments"s);
+            }
+            return static_cast<uint16_t>(count);
+        }
+
+        static uint32_t SlotOperand(size_t slot) {
+            if (slot > numeric_limits<uint32_t>::max()) {
+                throw runtime_error("Too many local variables"s);
+            }
+            return static_cast<uint32_t>(slot);
+        }
+
+        void CompileVariable(const ast::VariableValue& variable) {
+            if (variable.GetSlot() != ast::NO_SLOT) {
+                Emit(OpCode::LoadLocal, SlotOperand(variable.GetSlot()));
+            }
+            else {
+                Emit(OpCode::LoadName, AddName(variable.GetIds().front()));
+            }
+            for (size_t i = 1; i < variable.GetIds().size(); ++i) {
+                Emit(OpCode::LoadField, AddFieldSite(variable.GetIds()[i]));
+            }
+        }
+
+        void CompileMethodCall(ast::MethodCall& node) {
+            const uint16_t arg_count = ArgCount(node.GetArgs().size());
+            chunk_.call_sites.push_back({ AddName(node.GetMethod()), arg_count, 0, {} });
+            const auto site_index = static_cast<uint32_t>(chunk_.call_sites.size() - 1);
+
+            //     ,     ,   
+            CompileStatement(node.GetObject());
+            Emit(OpCode::LookupMethod, site_index);
+            for (const auto& arg : node.GetArgs()) {
+                CompileStatement(*arg);
+            }
+            Emit(OpCode::CallMethod, site_index, arg_count);
+            chunk_.call_sites[site_index].end = static_cast<uint32_t>(chunk_.code.size());
+        }
+
+        void CompileNewInstance(ast::NewInstance& node) {
+            chunk_.instance_sites.push_back({ node.GetClass(), node.GetInit() });
+            const auto site_index = static_cast<uint32_t>(chunk_.instance_sites.size() - 1);
+
+            //     ,       __init__
+            if (node.GetInit() == nullptr) {
+                Emit(OpCode::NewInstance, site_index);
+                return;
+            }
+            for (const auto& arg : node.GetArgs()) {
+                CompileStatement(*arg);
+            }
+            Emit(OpCode::NewInstance, site_index, ArgCount(node.GetArgs().size()));
+        }
+
+        void CompileBinary(ast::BinaryOperation& node, OpCode op) {
+            CompileStatement(node.GetLhs());
+            CompileStatement(node.GetRhs());
+            Emit(op);
+        }
+
+        // Or  And  : jump_op    ,
+        //       
+        void CompileLogical(ast::BinaryOperation& node, OpCode jump_op) {
+            const bool short_circuit_value = (jump_op == OpCode::JumpIfTrue);
+
+            CompileStatement(node.GetLhs());
+            const size_t lhs_jump = Emit(jump_op);
+            CompileStatement(node.GetRhs());
+            const size_t rhs_jump = Emit(jump_op);
+            EmitConstant(ObjectHolder::Own(runtime::Bool(!short_circuit_value)));
+            const size_t end_jump = Emit(OpCode::Jump);
+
+            --depth_;
+            PatchJump(lhs_jump);
+            PatchJump(rhs_jump);
+            EmitConstant(ObjectHolder::Own(runtime::Bool(short_circuit_value)));
+            PatchJump(end_jump);
+        }
+
+        void CompileComparison(ast::BuiltinComparison& node) {
+            switch (node.GetOp()) {
+            case runtime::CompareOp::Equal:
+                return CompileBinary(node, OpCode::Equal);
+            case runtime::CompareOp::NotEqual:
+                return CompileBinary(node, OpCode::NotEqual);
+            case runtime::CompareOp::Less:
+                return CompileBinary(node, OpCode::Less);
+            case runtime::CompareOp::Greater:
+                return CompileBinary(node, OpCode::Greater);
+            case runtime::CompareOp::LessOrEqual:
+                return CompileBinary(node, OpCode::LessOrEqual);
+            case runtime::CompareOp::GreaterOrEqual:
+                return CompileBinary(node, OpCode::GreaterOrEqual);
+            }
+            EmitNode(node);
+        }
+
+        void CompileIfElse(ast::IfElse& node) {
+            CompileStatement(node.GetCondition());
+            const size_t else_jump = Emit(OpCode::JumpIfFalse);
+            CompileStatement(node.GetIfBody());
+            Emit(OpCode::Pop);
+            const size_t end_jump = Emit(OpCode::Jump);
+
+            PatchJump(else_jump);
+            if (node.GetElseBody() != nullptr) {
+                CompileStatement(*node.GetElseBody());
+                Emit(OpCode::Pop);
+            }
+            PatchJump(end_jump);
+            Emit(OpCode::LoadNone);
+        }
+
+        Chunk& chunk_;
+        MethodTable& methods_;
+        int depth_ = 0;
+        unordered_map<runtime::Symbol, uint32_t> name_indices_;
+    };
+
+    namespace {
+        runtime::ClassInstance& AsInstance(const ObjectHolder& object) {
+            auto* instance = object.TryAs<runtime::ClassInstance>();
+            if (instance == nullptr) {
+                throw runtime_error("Object is not a class instance"s);
+            }
+            return *instance;
+        }
+
+        //     .   Run   
+        //   ,       
+        struct OperandStack {
+            vector<ObjectHolder> values;
+            // ,  LookupMethod    
+            vector<const runtime::Method*> methods;
+        };
+
+        OperandStack& ThreadOperandStack() {
+            thread_local OperandStack stack;
+            return stack;
+        }
+
+        //     ,     Run,     
+        class StackGuard {
+        public:
+            explicit StackGuard(OperandStack& stack)
+                : stack_(stack)
+                , values_size_(stack.values.size())
+                , methods_size_(stack.methods.size()) {
+            }
+
+            StackGuard(const StackGuard&) = delete;
+            StackGuard& operator=(const StackGuard&) = delete;
+
+            ~StackGuard() {
+                stack_.values.erase(stack_.values.begin() + values_size_, stack_.values.end());
+                stack_.methods.resize(methods_size_);
+            }
+
+        private:
+            OperandStack& stack_;
+            size_t values_size_;
+            size_t methods_size_;
+        };
+
+        //    ,   ,  
+        runtime::Executable& BodyOf(const Chunk& chunk, const runtime::Method& method) {
+            if (chunk.methods != nullptr) {
+                if (auto it = chunk.methods->find(&method); it != chunk.methods->end()) {
+                    return *it->second;
+                }
+            }
+            return *method.body;
+        }
+
+        void PrintValue(const ObjectHolder& object, ostream& os, Context& context) {
+            if (object) {
+                object->Print(os, context);
+            }
+            else {
+                os << "None"s;
+            }
+        }
+    }  // namespace
+
+    ObjectHolder Run(const Chunk& chunk, Closure& closure, Context& context) {
+        OperandStack& operands = ThreadOperandStack();
+        const StackGuard guard(operands);
+        vector<ObjectHolder>& stack = operands.values;
+        vector<const runtime::Method*>& methods = operands.methods;
+        if (stack.capacity() < stack.size() + chunk.max_stack) {
+            stack.reserve(max(stack.capacity() * 2, stack.size() + chunk.max_stack));
+        }
+
+        auto pop = [&stack]() {
+            ObjectHolder value = std::move(stack.back());
+            stack.pop_back();
+            return value;
+        };
+
+        //      ,       
+        runtime::LocalSlot* const frame = context.GetFrame();
+        const Instruction* code = chunk.code.data();
+        size_t ip = 0;
+        while (true) {
+            const Instruction& instr = code[ip++];
+            switch (instr.op) {
+            case OpCode::LoadConst:
+                stack.push_back(chunk.constants[instr.operand]);
+                break;
+
+            case OpCode::LoadNone:
+                stack.push_back(ObjectHolder::None());
+                break;
+
+            case OpCode::LoadName: {
+                auto it = closure.find(chunk.names[instr.operand]);
+                if (it == closure.end()) {
+                    throw runtime_error("Wrong variable!"s);
+                }
+                stack.push_back(it->second);
+                break;
+            }
+
+            case OpCode::StoreName:
+                closure[chunk.names[instr.operand]] = stack.back();
+                break;
+
+            case OpCode::LoadLocal: {
+                const runtime::LocalSlot& local = frame[instr.operand];
+                if (!local.bound) {
+                    throw runtime_error("Wrong variable!"s);
+                }
+                stack.push_back(local.value);
+                break;
+            }
+
+            case OpCode::StoreLocal:
+                frame[instr.operand] = { stack.back(), true };
+                break;
+
+            case OpCode::LoadField: {
+                ObjectHolder object = pop();
+                const FieldSite& site = chunk.field_sites[instr.operand];
+                ObjectHolder* field = site.cache.Find(AsInstance(object).Fields(), chunk.names[site.name]);
+                if (field == nullptr) {
+                    throw runtime_error("Wrong variable!"s);
+                }
+                stack.push_back(*field);
+                break;
+            }
+
+            case OpCode::StoreField: {
+                ObjectHolder value = pop();
+                ObjectHolder object = pop();
+                const FieldSite& site = chunk.field_sites[instr.operand];
+                site.cache.Emplace(AsInstance(object).Fields(), chunk.names[site.name]) = value;
+                stack.push_back(std::move(value));
+                break;
+            }
+
+            case OpCode::LookupMethod: {
+                const CallSite& site = chunk.call_sites[instr.operand];
+                const runtime::Class& cls = AsInstance(stack.back()).GetClass();
+                if (const runtime::Method* m = site.cache.Lookup(cls, chunk.names[site.name], site.arg_count)) {
+                    methods.push_back(m);
+                }
+                else {
+                    stack.back() = ObjectHolder::None();
+                    ip = site.end;
+                }
+                break;
+            }
+
+            //      .         ,
+            //      Run   
+            case OpCode::CallMethod: {
+                const size_t args_begin = stack.size() - instr.arg_count;
+                const runtime::Method* m = methods.back();
+                methods.pop_back();
+                const CallSite& site = chunk.call_sites[instr.operand];
+                if (site.last_method != m) {
+                    site.last_method = m;
+                    site.last_body = &BodyOf(chunk, *m);
+                }
+                ObjectHolder result = AsInstance(stack[args_begin - 1]).Call(*m, *site.last_body,
+                    stack.data() + args_begin, instr.arg_count, context);
+                stack.erase(stack.begin() + (args_begin - 1), stack.end());
+                stack.push_back(std::move(result));
+                break;
+            }
+
+            case OpCode::NewInstance: {
+                const size_t args_begin = stack.size() - instr.arg_count;
+                const InstanceSite& site = chunk.instance_sites[instr.operand];
+                ObjectHolder object = ObjectHolder::Own(runtime::ClassInstance(*site.cls));
+                if (site.init != nullptr) {
+                    if (site.init_body == nullptr) {
+                        site.init_body = &BodyOf(chunk, *site.init);
+                    }
+                    AsInstance(object).Call(*site.init, *site.init_body, stack.data() + args_begin,
+                        instr.arg_count, context);
+                }
+                stack.erase(stack.begin() + args_begin, stack.end());
+                stack.push_back(std::move(object));
+                break;
+            }
+
+            case OpCode::Stringify: {
+                ostringstream os;
+                PrintValue(pop(), os, context);
+                stack.push_back(ObjectHolder::Own(runtime::String(os.str())));
+                break;
+            }
+
+            case OpCode::Add: {
+                ObjectHolder rhs = pop();
+                ObjectHolder lhs = pop();
+                stack.push_back(runtime::Add(lhs, rhs, context));
+                break;
+            }
+
+            case OpCode::Sub: {
+                ObjectHolder rhs = pop();
+                ObjectHolder lhs = pop();
+                stack.push_back(runtime::Sub(lhs, rhs));
+                break;
+            }
+
+            case OpCode::Mult: {
+                ObjectHolder rhs = pop();
+                ObjectHolder lhs = pop();
+                stack.push_back(runtime::Mult(lhs, rhs));
+                break;
+            }
+
+            case OpCode::Div: {
+                ObjectHolder rhs = pop();
+                ObjectHolder lhs = pop();
+                stack.push_back(runtime::Div(lhs, rhs));
+                break;
+            }
+
+#define COMPARISON_CASE(name)                                                                \
+            case OpCode::name: {                                                             \
+                ObjectHolder rhs = pop();                                                    \
+                ObjectHolder lhs = pop();                                                    \
+                bool result = runtime::Compare<runtime::CompareOp::name>(lhs, rhs, context); \
+                stack.push_back(ObjectHolder::Own(runtime::Bool(result)));                   \
+                break;                                                                       \
+            }
+
+            COMPARISON_CASE(Equal)
+            COMPARISON_CASE(NotEqual)
+            COMPARISON_CASE(Less)
+            COMPARISON_CASE(Greater)
+            COMPARISON_CASE(LessOrEqual)
+            COMPARISON_CASE(GreaterOrEqual)
+
+#undef COMPARISON_CASE
+
+            case OpCode::Not:
+                stack.push_back(ObjectHolder::Own(runtime::Bool(!runtime::IsTrue(pop()))));
+                break;
+
+            case OpCode::Print: {
+                ostream& os = context.GetOutputStream();
+                if (instr.operand != 0) {
+                    os << ' ';
+                }
+                PrintValue(pop(), os, context);
+                break;
+            }
+
+            case OpCode::PrintNewline:
+                context.GetOutputStream() << '\n';
+                stack.push_back(ObjectHolder::None());
+                break;
+
+            case OpCode::Jump:
+                ip = instr.operand;
+                break;
+
+            case OpCode::JumpIfFalse:
+                if (!runtime::IsTrue(pop())) {
+                    ip = instr.operand;
+                }
+                break;
+
+            case OpCode::JumpIfTrue:
+                if (runtime::IsTrue(pop())) {
+                    ip = instr.operand;
+                }
+                break;
+
+            case OpCode::Pop:
+                stack.pop_back();
+                break;
+
+            case OpCode::Return:
+                return pop();
+
+            //    return. ,   MethodBody   ,
+            //      
+            case OpCode::ExecuteNode: {
+                ObjectHolder result = chunk.nodes[instr.operand]->Execute(closure, context);
+                if (context.IsReturning()) {
+                    context.SetReturning(false);
+                    return result;
+                }
+                stack.push_back(std::move(result));
+                break;
+            }
+            }
+        }
+    }
+
+    Function::Function(std::unique_ptr<runtime::Executable> source, Chunk chunk,
+        std::unique_ptr<MethodTable> methods)
+        : source_(std::move(source))
+        , methods_(std::move(methods))
+        , chunk_(std::move(chunk)) {
+    }
+
+    ObjectHolder Function::Execute(Closure& closure, Context& context) {
+        return Run(chunk_, closure, context);
+    }
+
+    const Chunk& Function::GetChunk() const {
+        return chunk_;
+    }
+
+    std::unique_ptr<runtime::Executable> Compile(std::unique_ptr<runtime::Executable> program) {
+        auto methods = make_unique<MethodTable>();
+        Chunk chunk;
+        Compiler compiler(chunk, *methods);
+        compiler.CompileStatement(*program);
+        compiler.Finish();
+        return make_unique<Function>(std::move(program), std::move(chunk), std::move(methods));
+    }
+
+}  // namespace bytecode
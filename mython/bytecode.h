@@ -0,0 +1,130 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bytecode {
+
+    //     Mython
+    enum class OpCode : std::uint8_t {
+        LoadConst,       //       operand
+        LoadNone,        //    None
+        LoadName,        //       names[operand]
+        StoreName,       //     names[operand],    
+        LoadLocal,       //     operand   
+        StoreLocal,      //     operand ,    
+        LoadField,       //        field_sites[operand]
+        StoreField,      //    ,   field_sites[operand],  
+        LookupMethod,    //     call_sites[operand]     .   ,
+                         //    None    ,   CallMethod
+        CallMethod,      //   LookupMethod    call_sites[operand]  arg_count 
+        NewInstance,     //    instance_sites[operand],  arg_count   __init__
+        Stringify,       //      
+        Add,
+        Sub,
+        Mult,
+        Div,
+        Equal,
+        NotEqual,
+        Less,
+        Greater,
+        LessOrEqual,
+        GreaterOrEqual,
+        Not,
+        Print,           //     ,   operand  
+        PrintNewline,    //    print   None
+        Jump,            //    operand
+        JumpIfFalse,     //       operand,   
+        JumpIfTrue,      //       operand,   
+        Pop,             //    
+        Return,          //  ,   
+        ExecuteNode,     //   AST nodes[operand],     
+    };
+
+    struct Instruction {
+        OpCode op;
+        std::uint16_t arg_count = 0;
+        std::uint32_t operand = 0;
+    };
+
+    //       
+    struct CallSite {
+        std::uint32_t name;
+        std::uint16_t arg_count;
+        // ,   CallMethod   
+        std::uint32_t end = 0;
+        //   ,      Chunk
+        mutable runtime::MethodCache cache;
+        //    ,        MethodTable
+        mutable const runtime::Method* last_method = nullptr;
+        mutable runtime::Executable* last_body = nullptr;
+    };
+
+    //         
+    struct FieldSite {
+        std::uint32_t name;
+        mutable runtime::FieldCache cache;
+    };
+
+    //    .  __init__    
+    //   , init  nullptr,    
+    struct InstanceSite {
+        const runtime::Class* cls;
+        const runtime::Method* init;
+        //   init,     .    
+        mutable runtime::Executable* init_body = nullptr;
+    };
+
+    class Function;
+
+    //     .     ,
+    //       ,     
+    using MethodTable = std::unordered_map<const runtime::Method*, std::unique_ptr<Function>>;
+
+    //     ,    
+    struct Chunk {
+        std::vector<Instruction> code;
+        std::vector<runtime::ObjectHolder> constants;
+        std::vector<runtime::Symbol> names;
+        std::vector<InstanceSite> instance_sites;
+        std::vector<CallSite> call_sites;
+        std::vector<FieldSite> field_sites;
+        //  AST,   ExecuteNode.   
+        std::vector<runtime::Executable*> nodes;
+        //   ,    .  Function 
+        const MethodTable* methods = nullptr;
+        //    ,   
+        size_t max_stack = 0;
+    };
+
+    //  chunk         Return
+    runtime::ObjectHolder Run(const Chunk& chunk, runtime::Closure& closure, runtime::Context& context);
+
+    //    .   ,   
+    //    ExecuteNode,     .
+    //     source  methods  nullptr:    
+    class Function : public runtime::Executable {
+    public:
+        Function(std::unique_ptr<runtime::Executable> source, Chunk chunk,
+            std::unique_ptr<MethodTable> methods = nullptr);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        [[nodiscard]] const Chunk& GetChunk() const;
+
+    private:
+        std::unique_ptr<runtime::Executable> source_;
+        std::unique_ptr<MethodTable> methods_;
+        Chunk chunk_;
+    };
+
+    //      .
+    //           Function
+    std::unique_ptr<runtime::Executable> Compile(std::unique_ptr<runtime::Executable> program);
+
+}  // namespace bytecode
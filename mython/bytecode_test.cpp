@@ -0,0 +1,154 @@
+#include "bytecode.h"
+#include "statement.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace bytecode {
+
+    namespace {
+
+        const Chunk& ChunkOf(const unique_ptr<runtime::Executable>& program) {
+            const auto* function = dynamic_cast<const Function*>(program.get());
+            ASSERT(function != nullptr);
+            return function->GetChunk();
+        }
+
+        bool HasOpCode(const Chunk& chunk, OpCode op) {
+            for (const Instruction& instr : chunk.code) {
+                if (instr.op == op) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // ,      .   
+        class Opaque : public ast::Statement {
+        public:
+            explicit Opaque(unique_ptr<ast::Statement> statement)
+                : statement_(std::move(statement)) {
+            }
+
+            runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override {
+                return statement_->Execute(closure, context);
+            }
+
+        private:
+            unique_ptr<ast::Statement> statement_;
+        };
+
+        void TestArithmeticsCompilesToOpCodes() {
+            auto program = Compile(make_unique<ast::Print>(make_unique<ast::Sub>(
+                make_unique<ast::NumericConst>(10), make_unique<ast::NumericConst>(3))));
+
+            const Chunk& chunk = ChunkOf(program);
+            ASSERT(HasOpCode(chunk, OpCode::Sub));
+            ASSERT(HasOpCode(chunk, OpCode::Print));
+            ASSERT(!HasOpCode(chunk, OpCode::ExecuteNode));
+            ASSERT(chunk.max_stack >= 2U);
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            program->Execute(closure, context);
+            ASSERT_EQUAL(context.output.str(), "7\n"s);
+        }
+
+        void TestShortCircuit() {
+            //    ,       
+            auto program = Compile(make_unique<ast::Print>(make_unique<ast::Or>(
+                make_unique<ast::BoolConst>(runtime::Bool(true)), make_unique<ast::VariableValue>("unknown"s))));
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            program->Execute(closure, context);
+            ASSERT_EQUAL(context.output.str(), "True\n"s);
+        }
+
+        void TestUnknownComparatorFallsBackToNode() {
+            auto always_true = [](const runtime::ObjectHolder&, const runtime::ObjectHolder&, runtime::Context&) {
+                return true;
+            };
+            auto program = Compile(make_unique<ast::Print>(make_unique<ast::Comparison>(
+                always_true, make_unique<ast::NumericConst>(1), make_unique<ast::StringConst>("1"s))));
+
+            ASSERT(HasOpCode(ChunkOf(program), OpCode::ExecuteNode));
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            program->Execute(closure, context);
+            ASSERT_EQUAL(context.output.str(), "True\n"s);
+        }
+
+        void TestMethodsAreCompiled() {
+            vector<runtime::Method> methods;
+            methods.push_back({ "get"s, {}, make_unique<ast::MethodBody>(make_unique<ast::Compound>(
+                make_unique<ast::Return>(make_unique<ast::NumericConst>(42)),
+                make_unique<ast::Print>(make_unique<ast::StringConst>("unreachable"s)))) });
+            auto cls = runtime::ObjectHolder::Own(runtime::Class("Answer"s, std::move(methods), nullptr));
+            auto& cls_ref = *cls.TryAs<runtime::Class>();
+
+            auto program = Compile(make_unique<ast::Compound>(
+                make_unique<ast::ClassDefinition>(cls),
+                make_unique<ast::Print>(make_unique<ast::MethodCall>(
+                    make_unique<ast::NewInstance>(cls_ref), "get"s, vector<unique_ptr<ast::Statement>>{}))));
+
+            //      ,     
+            const runtime::Method* get = cls_ref.GetMethod("get"s);
+            ASSERT(ChunkOf(program).methods->count(get) == 1U);
+            ASSERT(dynamic_cast<const ast::MethodBody*>(get->body.get()) != nullptr);
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            program->Execute(closure, context);
+            ASSERT_EQUAL(context.output.str(), "42\n"s);
+            ASSERT(closure.at("Answer"s).TryAs<runtime::Class>() == &cls_ref);
+
+            //         
+            ast::Print tree_walk(make_unique<ast::MethodCall>(
+                make_unique<ast::NewInstance>(cls_ref), "get"s, vector<unique_ptr<ast::Statement>>{}));
+            tree_walk.Execute(closure, context);
+            ASSERT_EQUAL(context.output.str(), "42\n42\n"s);
+        }
+
+        void TestReturnFromExecutedNode() {
+            vector<runtime::Method> methods;
+            methods.push_back({ "get"s, {}, make_unique<ast::MethodBody>(make_unique<ast::Compound>(
+                make_unique<Opaque>(make_unique<ast::Return>(make_unique<ast::NumericConst>(42))),
+                make_unique<ast::Print>(make_unique<ast::StringConst>("unreachable"s)))) });
+            auto cls = runtime::ObjectHolder::Own(runtime::Class("Answer"s, std::move(methods), nullptr));
+            auto& cls_ref = *cls.TryAs<runtime::Class>();
+
+            auto make_program = [&] {
+                return make_unique<ast::Compound>(
+                    make_unique<ast::ClassDefinition>(cls),
+                    make_unique<ast::Print>(make_unique<ast::MethodCall>(
+                        make_unique<ast::NewInstance>(cls_ref), "get"s, vector<unique_ptr<ast::Statement>>{})),
+                    make_unique<ast::Print>(make_unique<ast::StringConst>("after"s)));
+            };
+
+            //          return   ExecuteNode
+            unique_ptr<runtime::Executable> tree_walk = make_program();
+            unique_ptr<runtime::Executable> compiled = Compile(make_program());
+            for (const auto& program : { tree_walk.get(), compiled.get() }) {
+                runtime::DummyContext context;
+                runtime::Closure closure;
+                program->Execute(closure, context);
+                ASSERT_EQUAL(context.output.str(), "42\nafter\n"s);
+                ASSERT(!context.IsReturning());
+            }
+            const Function& get = *ChunkOf(compiled).methods->at(cls_ref.GetMethod("get"s));
+            ASSERT(HasOpCode(get.GetChunk(), OpCode::ExecuteNode));
+        }
+
+    }  // namespace
+
+    void RunBytecodeTests(TestRunner& tr) {
+        RUN_TEST(tr, bytecode::TestArithmeticsCompilesToOpCodes);
+        RUN_TEST(tr, bytecode::TestShortCircuit);
+        RUN_TEST(tr, bytecode::TestUnknownComparatorFallsBackToNode);
+        RUN_TEST(tr, bytecode::TestMethodsAreCompiled);
+        RUN_TEST(tr, bytecode::TestReturnFromExecutedNode);
+    }
+
+}  // namespace bytecode
@@ -0,0 +1,160 @@
+#include "constant_folding.h"
+
+#include "statement.h"
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+        bool IsConstant(const Statement* node) {
+            return dynamic_cast<const NumericConst*>(node) != nullptr || dynamic_cast<const StringConst*>(node) != nullptr
+                || dynamic_cast<const BoolConst*>(node) != nullptr || dynamic_cast<const None*>(node) != nullptr;
+        }
+
+        //  -   value.    , , Bool  None
+        unique_ptr<Statement> MakeConstant(const runtime::ObjectHolder& value) {
+            if (const auto* number = value.TryAs<runtime::Number>()) {
+                return make_unique<NumericConst>(number->GetValue());
+            }
+            if (const auto* str = value.TryAs<runtime::String>()) {
+                return make_unique<StringConst>(str->GetValue());
+            }
+            if (const auto* boolean = value.TryAs<runtime::Bool>()) {
+                return make_unique<BoolConst>(runtime::Bool(boolean->GetValue()));
+            }
+            return make_unique<None>();
+        }
+
+        //  -.     closure  context
+        runtime::ObjectHolder ConstantValue(Statement& node) {
+            runtime::Closure closure;
+            runtime::DummyContext context;
+            return node.Execute(closure, context);
+        }
+    }  // namespace
+
+    //     ,     .
+    //     ,      
+    class ConstantFolder {
+    public:
+        unique_ptr<Statement> Fold(unique_ptr<Statement> node) {
+            if (auto* p = dynamic_cast<UnaryOperation*>(node.get())) {
+                FoldChildren(*p);
+                if (IsConstant(&p->GetArgument())) {
+                    return Evaluate(std::move(node));
+                }
+            }
+            else if (auto* p = dynamic_cast<Or*>(node.get())) {
+                return FoldLogical(std::move(node), *p, true);
+            }
+            else if (auto* p = dynamic_cast<And*>(node.get())) {
+                return FoldLogical(std::move(node), *p, false);
+            }
+            else if (auto* p = dynamic_cast<Comparison*>(node.get())) {
+                //  comparator    ,   
+                FoldChildren(*p);
+            }
+            else if (auto* p = dynamic_cast<BinaryOperation*>(node.get())) {
+                // Add, Sub, Mult, Div   
+                FoldChildren(*p);
+                if (IsConstant(&p->GetLhs()) && IsConstant(&p->GetRhs())) {
+                    return Evaluate(std::move(node));
+                }
+            }
+            else if (auto* p = dynamic_cast<Compound*>(node.get())) {
+                FoldCompound(*p);
+            }
+            else if (auto* p = dynamic_cast<ClassDefinition*>(node.get())) {
+                FoldMethods(*p->GetClass().TryAs<runtime::Class>());
+            }
+            else if (auto* p = dynamic_cast<IfElse*>(node.get())) {
+                return FoldIfElse(std::move(node), *p);
+            }
+            else {
+                // , print,  ,    return
+                FoldChildren(*node);
+            }
+            return node;
+        }
+
+    private:
+        void FoldChild(unique_ptr<Statement>& child) {
+            if (child != nullptr) {
+                child = Fold(std::move(child));
+            }
+        }
+
+        void FoldChildren(Statement& node) {
+            VisitChildren(node, [this](unique_ptr<Statement>& child) {
+                FoldChild(child);
+            });
+        }
+
+        void FoldMethods(runtime::Class& cls) {
+            cls.ForEachMethodBody([this](unique_ptr<Statement>& body) {
+                FoldChild(body);
+            });
+        }
+
+        //       .   
+        // runtime_error,  ,      
+        static unique_ptr<Statement> Evaluate(unique_ptr<Statement> node) {
+            try {
+                return MakeConstant(ConstantValue(*node));
+            }
+            catch (const runtime_error&) {
+                return node;
+            }
+        }
+
+        // Or  And    ,   (True  or, False  and),
+        //       
+        unique_ptr<Statement> FoldLogical(unique_ptr<Statement> node, BinaryOperation& op, bool short_circuit_value) {
+            FoldChildren(op);
+            if (!IsConstant(&op.GetLhs())) {
+                return node;
+            }
+            if (runtime::IsTrue(ConstantValue(op.GetLhs())) == short_circuit_value) {
+                return make_unique<BoolConst>(runtime::Bool(short_circuit_value));
+            }
+            if (IsConstant(&op.GetRhs())) {
+                return Evaluate(std::move(node));
+            }
+            return node;
+        }
+
+        unique_ptr<Statement> FoldIfElse(unique_ptr<Statement> node, IfElse& if_else) {
+            FoldChildren(if_else);
+            if (!IsConstant(&if_else.GetCondition())) {
+                return node;
+            }
+            auto branch = if_else.TakeBranch(runtime::IsTrue(ConstantValue(if_else.GetCondition())));
+            if (branch != nullptr) {
+                return branch;
+            }
+            return make_unique<None>();
+        }
+
+        //          ,   
+        // ,    if, : Compound     return
+        void FoldCompound(Compound& compound) {
+            for (auto& arg : compound.TakeStatements()) {
+                auto statement = Fold(std::move(arg));
+                if (auto* nested = dynamic_cast<Compound*>(statement.get())) {
+                    for (auto& nested_statement : nested->TakeStatements()) {
+                        compound.AddStatement(std::move(nested_statement));
+                    }
+                }
+                else if (!IsConstant(statement.get())) {
+                    compound.AddStatement(std::move(statement));
+                }
+            }
+        }
+    };
+
+    unique_ptr<runtime::Executable> FoldConstants(unique_ptr<runtime::Executable> program) {
+        return ConstantFolder{}.Fold(std::move(program));
+    }
+
+}  // namespace ast
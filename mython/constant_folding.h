@@ -0,0 +1,21 @@
+#pragma once
+
+#include <memory>
+
+namespace runtime {
+    class Executable;
+}
+
+namespace ast {
+
+    /*
+     *      .      ,
+     * not, and  or  ,   str       .
+     *  if      ,    
+     *    .         .
+     *       (,   ),
+     *    ,     
+     */
+    std::unique_ptr<runtime::Executable> FoldConstants(std::unique_ptr<runtime::Executable> program);
+
+}  // namespace ast
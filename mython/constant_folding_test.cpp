@@ -0,0 +1,133 @@
+#include "bytecode.h"
+#include "constant_folding.h"
+#include "lexer.h"
+#include "parse.h"
+#include "statement.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+
+        template <typename Node>
+        bool Is(const unique_ptr<Statement>& node) {
+            return dynamic_cast<const Node*>(node.get()) != nullptr;
+        }
+
+        string Run(Statement& program) {
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            program.Execute(closure, context);
+            return context.output.str();
+        }
+
+        void TestArithmeticIsFolded() {
+            //       -1     
+            auto negative = FoldConstants(make_unique<Mult>(make_unique<NumericConst>(5), make_unique<NumericConst>(-1)));
+            ASSERT(Is<NumericConst>(negative));
+
+            auto expression = FoldConstants(make_unique<Div>(
+                make_unique<Mult>(make_unique<Add>(make_unique<NumericConst>(2), make_unique<NumericConst>(3)),
+                    make_unique<NumericConst>(4)),
+                make_unique<Sub>(make_unique<NumericConst>(10), make_unique<NumericConst>(7))));
+            ASSERT(Is<NumericConst>(expression));
+
+            auto str = FoldConstants(make_unique<Add>(make_unique<StringConst>("ab"s),
+                make_unique<Stringify>(make_unique<NumericConst>(12))));
+            ASSERT(Is<StringConst>(str));
+
+            ASSERT_EQUAL(Run(*FoldConstants(make_unique<Print>(std::move(negative)))), "-5\n"s);
+            ASSERT_EQUAL(Run(*FoldConstants(make_unique<Print>(std::move(expression)))), "6\n"s);
+            ASSERT_EQUAL(Run(*FoldConstants(make_unique<Print>(std::move(str)))), "ab12\n"s);
+        }
+
+        void TestErrorsAreKept() {
+            //             
+            auto division = FoldConstants(make_unique<Print>(make_unique<Div>(
+                make_unique<NumericConst>(1), make_unique<Sub>(make_unique<NumericConst>(2), make_unique<NumericConst>(2)))));
+            ASSERT_THROWS(Run(*division), runtime_error);
+
+            auto addition = FoldConstants(make_unique<Add>(make_unique<NumericConst>(1), make_unique<StringConst>("1"s)));
+            ASSERT(Is<Add>(addition));
+            ASSERT_THROWS(Run(*addition), runtime_error);
+        }
+
+        void TestLogicalOperationsAreFolded() {
+            auto not_string = FoldConstants(make_unique<Not>(make_unique<StringConst>(""s)));
+            ASSERT(Is<BoolConst>(not_string));
+            ASSERT_EQUAL(Run(*make_unique<Print>(std::move(not_string))), "True\n"s);
+
+            auto both = FoldConstants(make_unique<And>(make_unique<NumericConst>(1), make_unique<StringConst>("x"s)));
+            ASSERT(Is<BoolConst>(both));
+            ASSERT_EQUAL(Run(*make_unique<Print>(std::move(both))), "True\n"s);
+
+            //        
+            auto either = FoldConstants(make_unique<Or>(make_unique<BoolConst>(runtime::Bool(true)),
+                make_unique<VariableValue>("unknown"s)));
+            ASSERT(Is<BoolConst>(either));
+            auto neither = FoldConstants(make_unique<And>(make_unique<None>(), make_unique<VariableValue>("unknown"s)));
+            ASSERT(Is<BoolConst>(neither));
+            ASSERT_EQUAL(Run(*make_unique<Print>(std::move(neither))), "False\n"s);
+
+            //  and    
+            auto variable = FoldConstants(make_unique<And>(make_unique<NumericConst>(1), make_unique<VariableValue>("x"s)));
+            ASSERT(Is<And>(variable));
+
+            auto comparison = FoldConstants(MakeComparison(runtime::CompareOp::Less,
+                make_unique<StringConst>("a"s), make_unique<StringConst>("b"s)));
+            ASSERT(Is<BoolConst>(comparison));
+        }
+
+        void TestConstantBranchesAreSelected() {
+            const string program = R"(
+class Counter:
+  def __init__():
+    if False:
+      self.value = 1 / 0
+    else:
+      self.value = -2 * 3
+    if 'debug' and 0:
+      print 'unreachable'
+
+  def get():
+    if True:
+      return self.value
+    return 0
+
+c = Counter()
+if not None:
+  print c.get(), -(1 + 2), 'a' + 'b'
+x = 10
+if x > 5:
+  print x - -1
+)"s;
+            for (const bool compile : { false, true }) {
+                istringstream input(program);
+                parse::Lexer lexer(input);
+                auto tree = ParseProgram(lexer);
+                if (compile) {
+                    tree = bytecode::Compile(std::move(tree));
+                }
+                ASSERT_EQUAL(Run(*tree), "-6 -3 ab\n11\n"s);
+            }
+
+            auto dead = FoldConstants(make_unique<Compound>(
+                make_unique<IfElse>(make_unique<NumericConst>(0), make_unique<Print>(make_unique<NumericConst>(1)), nullptr),
+                make_unique<IfElse>(make_unique<StringConst>("yes"s),
+                    make_unique<Compound>(make_unique<Print>(make_unique<NumericConst>(2))),
+                    make_unique<Print>(make_unique<NumericConst>(3)))));
+            ASSERT_EQUAL(Run(*dead), "2\n"s);
+        }
+
+    }  // namespace
+
+    void RunConstantFoldingTests(TestRunner& tr) {
+        RUN_TEST(tr, ast::TestArithmeticIsFolded);
+        RUN_TEST(tr, ast::TestErrorsAreKept);
+        RUN_TEST(tr, ast::TestLogicalOperationsAreFolded);
+        RUN_TEST(tr, ast::TestConstantBranchesAreSelected);
+    }
+
+}  // namespace ast
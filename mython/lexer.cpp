@@ -1,13 +1,138 @@
 #include "lexer.h"
 
+#include "scan.h"
+#include "spsc_queue.h"
+
 #include <algorithm>
+#include <array>
 #include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <thread>
 #include <unordered_map>
 
 using namespace std;
 
 namespace parse {
 
+    namespace {
+
+        enum class KeyWord : uint8_t {
+            NotKeyWord,
+            Class,
+            Return,
+            If,
+            Else,
+            Def,
+            Print,
+            And,
+            Or,
+            Not,
+            None,
+            True,
+            False,
+        };
+
+        //       ,    
+        //   ,    
+        constexpr KeyWord ClassifyKeyWord(string_view word) {
+            if (word.size() < 2 || word.size() > 6) {
+                return KeyWord::NotKeyWord;
+            }
+            const auto match = [word](string_view key_word, KeyWord result) {
+                return word == key_word ? result : KeyWord::NotKeyWord;
+            };
+            switch (word[0]) {
+            case 'c':
+                return match("class"sv, KeyWord::Class);
+            case 'r':
+                return match("return"sv, KeyWord::Return);
+            case 'i':
+                return match("if"sv, KeyWord::If);
+            case 'e':
+                return match("else"sv, KeyWord::Else);
+            case 'd':
+                return match("def"sv, KeyWord::Def);
+            case 'p':
+                return match("print"sv, KeyWord::Print);
+            case 'a':
+                return match("and"sv, KeyWord::And);
+            case 'o':
+                return match("or"sv, KeyWord::Or);
+            case 'n':
+                return match("not"sv, KeyWord::Not);
+            case 'N':
+                return match("None"sv, KeyWord::None);
+            case 'T':
+                return match("True"sv, KeyWord::True);
+            case 'F':
+                return match("False"sv, KeyWord::False);
+            default:
+                return KeyWord::NotKeyWord;
+            }
+        }
+
+        static_assert(ClassifyKeyWord("class"sv) == KeyWord::Class);
+        static_assert(ClassifyKeyWord("False"sv) == KeyWord::False);
+        static_assert(ClassifyKeyWord("classes"sv) == KeyWord::NotKeyWord);
+        static_assert(ClassifyKeyWord("iff"sv) == KeyWord::NotKeyWord);
+        static_assert(ClassifyKeyWord("x"sv) == KeyWord::NotKeyWord);
+
+        Token MakeKeyWordToken(KeyWord key_word) {
+            switch (key_word) {
+            case KeyWord::Class:
+                return token_type::Class();
+            case KeyWord::Return:
+                return token_type::Return();
+            case KeyWord::If:
+                return token_type::If();
+            case KeyWord::Else:
+                return token_type::Else();
+            case KeyWord::Def:
+                return token_type::Def();
+            case KeyWord::Print:
+                return token_type::Print();
+            case KeyWord::And:
+                return token_type::And();
+            case KeyWord::Or:
+                return token_type::Or();
+            case KeyWord::Not:
+                return token_type::Not();
+            case KeyWord::None:
+                return token_type::None();
+            case KeyWord::True:
+                return token_type::True();
+            case KeyWord::False:
+                return token_type::False();
+            case KeyWord::NotKeyWord:
+                break;
+            }
+            throw LexerError("Invalid Key Word"s);
+        }
+
+        // ,    token_type::Char
+        constexpr array<bool, 256> MakeOperatorTable() {
+            array<bool, 256> table{};
+            for (const char c : "=.,()+-*/<>:"sv) {
+                table[static_cast<unsigned char>(c)] = true;
+            }
+            return table;
+        }
+
+        constexpr array<bool, 256> OPERATOR_CHARS = MakeOperatorTable();
+
+        //  token_type::String    32- 
+        void CheckSourceSize(string_view source) {
+            if (source.size() > static_cast<size_t>(numeric_limits<int32_t>::max())) {
+                throw LexerError("Program text is too large"s);
+            }
+        }
+
+    }  // namespace
+
     bool operator==(const Token& lhs, const Token& rhs) {
         using namespace token_type;
 
@@ -21,7 +146,10 @@ namespace parse {
             return lhs.As<Number>().value == rhs.As<Number>().value;
         }
         if (lhs.Is<String>()) {
-            return lhs.As<String>().value == rhs.As<String>().value;
+            //    ,    
+            const auto& l = lhs.As<String>();
+            const auto& r = rhs.As<String>();
+            return l.offset == r.offset && l.length == r.length && l.unescaped == r.unescaped;
         }
         if (lhs.Is<Id>()) {
             return lhs.As<Id>().value == rhs.As<Id>().value;
@@ -41,7 +169,9 @@ namespace parse {
 
         VALUED_OUTPUT(Number);
         VALUED_OUTPUT(Id);
-        VALUED_OUTPUT(String);
+        if (auto p = rhs.TryAs<String>()) {
+            return os << "String{"sv << p->offset << ", "sv << p->length << '}';
+        }
         VALUED_OUTPUT(Char);
 
 #undef VALUED_OUTPUT
@@ -75,27 +205,168 @@ namespace parse {
         return os << "Unknown token :("sv;
     }
 
+    struct Lexer::Pipeline {
+        //  : 64  ,    
+        static constexpr size_t CAPACITY = 4096;
+
+        SpscQueue<Token, CAPACITY> queue;
+        //    ,     
+        std::atomic<bool> stop{ false };
+        //   ,       error
+        std::atomic<bool> failed{ false };
+        std::exception_ptr error;
+        std::thread thread;
+
+        ~Pipeline() {
+            stop.store(true, std::memory_order_relaxed);
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    };
+
     Lexer::Lexer(std::istream& input) 
-        : input_(input)
+        : buffer_(istreambuf_iterator<char>(input), istreambuf_iterator<char>())
+        , input_(buffer_)
+        , new_line_flag_(true)
+    {
+        CheckSourceSize(input_);
+        tokens_.push_back(ParseToken());
+    }
+
+    Lexer::Lexer(std::string_view source, Mode mode)
+        : input_(source)
         , new_line_flag_(true)
     {
-        NextToken();
+        CheckSourceSize(input_);
+        if (mode == Mode::Tokenized) {
+            //     :       
+            tokens_.reserve(input_.size() / 4 + 1);
+            do {
+                tokens_.push_back(ParseToken());
+            } while (!tokens_.back().Is<token_type::Eof>());
+        }
+        else if (mode == Mode::Pipelined) {
+            pipeline_ = std::make_unique<Pipeline>();
+            pipeline_->thread = std::thread([this] {
+                RunPipeline();
+            });
+            tokens_.push_back(ReceiveToken());
+        }
+        else {
+            tokens_.push_back(ParseToken());
+        }
+    }
+
+    Lexer::~Lexer() = default;
+
+    void Lexer::RunPipeline() {
+        Pipeline& pipeline = *pipeline_;
+        try {
+            Token token;
+            do {
+                token = ParseToken();
+                while (!pipeline.queue.TryPush(token)) {
+                    if (pipeline.stop.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    this_thread::yield();
+                }
+            } while (!token.Is<token_type::Eof>());
+        }
+        catch (...) {
+            pipeline.error = current_exception();
+            pipeline.failed.store(true, std::memory_order_release);
+        }
+    }
+
+    Token Lexer::ReceiveToken() {
+        Pipeline& pipeline = *pipeline_;
+        Token token;
+        while (!pipeline.queue.TryPop(token)) {
+            if (pipeline.failed.load(std::memory_order_acquire)) {
+                // ,   ,    ,   
+                if (pipeline.queue.TryPop(token)) {
+                    break;
+                }
+                rethrow_exception(pipeline.error);
+            }
+            this_thread::yield();
+        }
+        return token;
+    }
+
+    std::string_view Lexer::GetString(const token_type::String& str) const {
+        const char* data = str.unescaped ? unescaped_.get() : input_.data();
+        return { data + str.offset, str.length };
+    }
+
+    bool Lexer::Get(char& c) {
+        if (pos_ == input_.size()) {
+            return false;
+        }
+        c = input_[pos_++];
+        return true;
+    }
+
+    char Lexer::PeekChar() const {
+        return pos_ < input_.size() ? input_[pos_] : '\0';
+    }
+
+    void Lexer::Unget() {
+        --pos_;
+    }
+
+    const char* Lexer::Cursor() const {
+        return input_.data() + pos_;
+    }
+
+    const char* Lexer::End() const {
+        return input_.data() + input_.size();
     }
 
     const Token& Lexer::CurrentToken() const {
-        return current_token_;
-        //throw std::logic_error("Not implemented"s);
+        return tokens_[token_index_];
     }
 
     Token Lexer::NextToken() {
-        current_token_ = ParseToken();
+        if (token_index_ + 1 < tokens_.size() || LexMore()) {
+            ++token_index_;
+        }
         return CurrentToken();
-        //throw std::logic_error("Not implemented"s);
+    }
+
+    const Token& Lexer::Peek(size_t n) {
+        while (tokens_.size() - token_index_ <= n) {
+            if (!LexMore()) {
+                break;
+            }
+        }
+        return tokens_[min(token_index_ + n, tokens_.size() - 1)];
+    }
+
+    size_t Lexer::Mark() const {
+        return token_index_;
+    }
+
+    void Lexer::Rewind(size_t mark) {
+        if (mark >= tokens_.size()) {
+            throw LexerError("Invalid token mark"s);
+        }
+        token_index_ = mark;
+    }
+
+    bool Lexer::LexMore() {
+        if (tokens_.back().Is<token_type::Eof>()) {
+            return false;
+        }
+        tokens_.push_back(pipeline_ ? ReceiveToken() : ParseToken());
+        return true;
     }
 
     Token Lexer::ParseToken() {
         char c;
-        while (input_.get(c)) {
+        while (Get(c)) {
             if (c == '\n') {
                 if (!new_line_flag_) {
                     return ParseNewLine();
@@ -107,7 +378,7 @@ namespace parse {
             if (c == ' ') {
                 if (new_line_flag_) {
                     new_line_flag_ = false;
-                    input_.putback(c);
+                    Unget();
                     Token token = ParseIndent();
                     if (token == token_type::None()) {
                         continue;
@@ -115,29 +386,30 @@ namespace parse {
                     return token;
                 }
                 else {
+                    pos_ += scan::CountSpaces(Cursor(), End());
                     continue;
                 }
             }
             else {
                 if (new_line_flag_ && (current_indent_ != 0)) {
-                    input_.putback(c);
+                    Unget();
                     return ParseDedent();
                 }
             }
             if (isalpha(c) || c == '_') {
                 new_line_flag_ = false;
-                input_.putback(c);
+                Unget();
                 return ParseId();
             }
             if (isdigit(c)) {
                 new_line_flag_ = false;
-                input_.putback(c);
+                Unget();
                 return ParseNumber();
             }
             if (ispunct(c)) {
                 if (c == '\"' || c == '\'') {
                     new_line_flag_ = false;
-                    input_.putback(c);
+                    Unget();
                     return ParseString();
                 }
                 else if (c == '#') {
@@ -151,7 +423,7 @@ namespace parse {
                 }
                 else {
                     new_line_flag_ = false;
-                    input_.putback(c);
+                    Unget();
                     return ParseChar();
                 }
             }
@@ -170,81 +442,124 @@ namespace parse {
     }
 
     Token Lexer::ParseString() {
-        char open_quote = input_.get();
-        string str;
+        char open_quote = '\0';
+        Get(open_quote);
+        const size_t begin = pos_;
+
+        //     escape-:   
+        //     ,       
+        const auto* close_quote = static_cast<const char*>(memchr(Cursor(), open_quote, End() - Cursor()));
+        if (close_quote == nullptr) {
+            throw LexerError("Unterminated string"s);
+        }
+        const auto spelled_length = static_cast<size_t>(close_quote - Cursor());
+        if (memchr(Cursor(), '\\', spelled_length) == nullptr) {
+            pos_ += spelled_length + 1;
+            return token_type::String{ static_cast<uint32_t>(begin),
+                static_cast<uint32_t>(spelled_length), 0 };
+        }
+
+        //       ,
+        //     unescaped_     begin
+        if (!unescaped_) {
+            unescaped_ = make_unique<char[]>(input_.size());
+        }
+        char* const unescaped = unescaped_.get() + begin;
+        size_t length = 0;
         while (true) {
-            char c = input_.get();
+            char c;
+            if (!Get(c)) {
+                throw LexerError("Unterminated string"s);
+            }
             if (c == '\\') {
-                const char escaped_char = input_.get();
+                char escaped_char;
+                if (!Get(escaped_char)) {
+                    throw LexerError("Unterminated string"s);
+                }
                 switch (escaped_char) {
                 case 'n':
-                    str.push_back('\n');
+                    unescaped[length++] = '\n';
                     break;
                 case 't':
-                    str.push_back('\t');
+                    unescaped[length++] = '\t';
                     break;
                 case 'r':
-                    str.push_back('\r');
+                    unescaped[length++] = '\r';
                     break;
                 case '"':
-                    str.push_back('\"');
+                    unescaped[length++] = '\"';
                     break;
                 case '\'':
-                    str.push_back('\'');
+                    unescaped[length++] = '\'';
                     break;
                 case '\\':
-                    str.push_back('\\');
+                    unescaped[length++] = '\\';
                     break;
                 default:
-                    str.push_back(escaped_char);
+                    unescaped[length++] = escaped_char;
                 }
             }
             else if (c == '\"' || c == '\'') {
                 if (c == open_quote) {
                     break;
                 }
-                str.push_back(c);
+                unescaped[length++] = c;
             }
             else {
-                str.push_back(c);
+                unescaped[length++] = c;
             }
             
         }
-        return token_type::String{ str };
+        return token_type::String{ static_cast<uint32_t>(begin), static_cast<uint32_t>(length), 1 };
     }
 
     Token Lexer::ParseNumber() {
-        string parse_num;
-        while (isdigit(input_.peek())) {
-            parse_num.push_back(static_cast<char>(input_.get()));
+        const size_t start = pos_;
+        while (isdigit(static_cast<unsigned char>(PeekChar()))) {
+            ++pos_;
         }
-        return token_type::Number{ stoi(parse_num) };
+        int value = 0;
+        auto [end, error] = from_chars(input_.data() + start, input_.data() + pos_, value);
+        if (error != errc()) {
+            throw LexerError("Invalid number "s + string(input_.substr(start, pos_ - start)));
+        }
+        return token_type::Number{ value };
     }
 
     Token Lexer::ParseId() {
-        string str;
-        while (std::isalpha(input_.peek()) || std::isdigit(input_.peek()) || input_.peek() == '_') {
-            str.push_back(static_cast<char>(input_.get()));
-        }
-        if (key_words_.count(str)) {
-            return ParseKeyWord(str);
+        const size_t start = pos_;
+        pos_ += scan::CountIdChars(Cursor(), End());
+        const string_view word = input_.substr(start, pos_ - start);
+        if (const KeyWord key_word = ClassifyKeyWord(word); key_word != KeyWord::NotKeyWord) {
+            return MakeKeyWordToken(key_word);
         }
         else {
-            return token_type::Id{ str };
+            return token_type::Id{ runtime::Symbol(word) };
         }
     }
 
     Token Lexer::ParseChar() {
-        char c = input_.get();
-        if (c == '<' || c == '>' || c == '!' || c == '=') {
-            if (input_.peek() == '=') {
-                string str;
-                str.push_back(c);
-                str.push_back(static_cast<char>(input_.get()));
-                return ParseKeyWord(str);
+        char c = '\0';
+        Get(c);
+        if (PeekChar() == '=') {
+            switch (c) {
+            case '=':
+                ++pos_;
+                return token_type::Eq();
+            case '!':
+                ++pos_;
+                return token_type::NotEq();
+            case '<':
+                ++pos_;
+                return token_type::LessOrEq();
+            case '>':
+                ++pos_;
+                return token_type::GreaterOrEq();
+            default:
+                break;
             }
         }
-        if (chars_.count(c)) {
+        if (OPERATOR_CHARS[static_cast<unsigned char>(c)]) {
             return token_type::Char{ c };
         }
         else {
@@ -252,89 +567,31 @@ namespace parse {
         }
     }
 
-    Token Lexer::ParseKeyWord(string str) {
-        if (str == "class"s) {
-            return token_type::Class();
-        }
-        if (str == "return"s) {
-            return token_type::Return();
-        }
-        if (str == "if"s) {
-            return token_type::If();
-        }
-        if (str == "else"s) {
-            return token_type::Else();
-        }
-        if (str == "def"s) {
-            return token_type::Def();
-        }
-        if (str == "print"s) {
-            return token_type::Print();
-        }
-        if (str == "and"s) {
-            return token_type::And();
-        }
-        if (str == "or"s) {
-            return token_type::Or();
-        }
-        if (str == "not"s) {
-            return token_type::Not();
-        }
-        if (str == "=="s) {
-            return token_type::Eq();
-        }
-        if (str == "!="s) {
-            return token_type::NotEq();
-        }
-        if (str == "<="s) {
-            return token_type::LessOrEq();
-        }
-        if (str == ">="s) {
-            return token_type::GreaterOrEq();
+    Token Lexer::ParseIndent() {
+        const size_t space_counter = scan::CountSpaces(Cursor(), End());
+        pos_ += space_counter;
+        if (pos_ == input_.size()) {
+            return token_type::None();
         }
-        if (str == "None"s) {
+        if (input_[pos_] == '\n') {
+            ++pos_;
             return token_type::None();
         }
-        if (str == "True"s) {
-            return token_type::True();
+        if (space_counter % 2 != 0) {
+            throw LexerError("Invalid number of spaces"s);
         }
-        if (str == "False"s) {
-            return token_type::False();
+        if (space_counter / 2 > current_indent_) {
+            ++current_indent_;
+            return token_type::Indent();
         }
-        throw LexerError("Invalid Key Word"s);
-    }
-
-    Token Lexer::ParseIndent() {
-        size_t space_counter = 0;
-        char c;
-        while (input_.get(c)) {
-            if (c == '\n') {
-                return token_type::None();
-            }
-            if (c == ' ') {
-                ++space_counter;
-            }
-            else {
-                input_.putback(c);
-                if (space_counter % 2 == 0) {
-                    if (space_counter / 2 > current_indent_) {
-                        ++current_indent_;
-                        return token_type::Indent();
-                    }
-                    if (space_counter / 2 < current_indent_) {
-                        if ((space_counter / 2) < (current_indent_ - 1)) {
-                            new_line_flag_ = true;
-                            input_.putback(' ');
-                            input_.putback(' ');
-                        }
-                        return ParseDedent();
-                    }
-                    return token_type::None();
-                }
-                else {
-                    throw LexerError("Invalid number of spaces"s);
-                }
+        if (space_counter / 2 < current_indent_) {
+            if ((space_counter / 2) < (current_indent_ - 1)) {
+                new_line_flag_ = true;
+                //        :
+                //    ,    
+                pos_ -= 2;
             }
+            return ParseDedent();
         }
         return token_type::None();
     }
@@ -350,9 +607,10 @@ namespace parse {
     }
 
     Token Lexer::ParseComment() {
-        char c;
-        while (input_.get(c) && c != '\n') {
-            continue;
+        const char* newline = scan::FindNewline(Cursor(), End());
+        pos_ = static_cast<size_t>(newline - input_.data());
+        if (pos_ != input_.size()) {
+            ++pos_;
         }
         if (new_line_flag_) {
             return token_type::None();
@@ -1,12 +1,18 @@
 #pragma once
 
+#include "symbol.h"
+
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <variant>
-#include <set>
+#include <vector>
 
 using namespace std::literals;
 
@@ -17,16 +23,20 @@ namespace parse {
             int value;   // 
         };
 
-        struct Id {             //  
-            std::string value;  //  
+        struct Id {                 //  
+            runtime::Symbol value;  //  ,    
         };
 
         struct Char {    //  
             char value;  //  
         };
 
-        struct String {  //   
-            std::string value;
+        //   .    ,     
+        //     ,       Lexer::GetString
+        struct String {
+            std::uint32_t offset;         //  
+            std::uint32_t length : 31;    //  
+            std::uint32_t unescaped : 1;  //   escape-     
         };
 
         struct Class {};    //  class
@@ -78,6 +88,11 @@ namespace parse {
         }
     };
 
+    //     :  ,      ,
+    //              
+    static_assert(sizeof(Token) <= 16);
+    static_assert(std::is_trivially_copyable_v<Token>);
+
     bool operator==(const Token& lhs, const Token& rhs);
     bool operator!=(const Token& lhs, const Token& rhs);
 
@@ -90,7 +105,28 @@ namespace parse {
 
     class Lexer {
     public:
+        enum class Mode {
+            //       
+            OnDemand,
+            //         
+            Tokenized,
+            //          ,
+            //      
+            Pipelined,
+        };
+
+        //         
         explicit Lexer(std::istream& input);
+        //   source  .   ,   
+        explicit Lexer(std::string_view source, Mode mode = Mode::OnDemand);
+
+        Lexer(const Lexer&) = delete;
+        Lexer& operator=(const Lexer&) = delete;
+        ~Lexer();
+
+        //    ,   .
+        //   ,       
+        [[nodiscard]] std::string_view GetString(const token_type::String& str) const;
 
         //       token_type::Eof,    
         [[nodiscard]] const Token& CurrentToken() const;
@@ -98,13 +134,23 @@ namespace parse {
         //   ,  token_type::Eof,    
         Token NextToken();
 
+        //  ,   n    (Peek(0) -  ),
+        //  token_type::Eof,     .
+        //   Mode::Tokenized   O(1)
+        const Token& Peek(size_t n);
+
+        //      
+        [[nodiscard]] size_t Mark() const;
+        //      mark,    Mark
+        void Rewind(size_t mark);
+
         //      T,     .
         //       LexerError
         template <typename T>
         const T& Expect() const {
             using namespace std::literals;
-            if (current_token_.Is<T>()) {
-                return current_token_.As<T>();
+            if (CurrentToken().Is<T>()) {
+                return CurrentToken().As<T>();
             }
             else {
                 throw LexerError("Invalid Token"s);
@@ -141,24 +187,55 @@ namespace parse {
 
     private:
         //    
-        Token current_token_;
-        std::istream& input_;
+
+        // ,     Mode::Pipelined,     
+        struct Pipeline;
+
+        //  .   ,        Rewind
+        std::vector<Token> tokens_;
+        //     tokens_
+        size_t token_index_ = 0;
+        //  ,     
+        std::string buffer_;
+        //    escape-.    
+        //    ,       ,    input_.
+        //   Mode::Pipelined     ,   
+        //     
+        std::unique_ptr<char[]> unescaped_;
+        std::string_view input_;
+        //      input_
+        size_t pos_ = 0;
         size_t current_indent_ = 0;
         bool new_line_flag_;
-        std::set<std::string> key_words_ = {"class"s, "return"s, "if"s, "else"s, "def"s, "print"s, 
-            "and"s, "or"s, "not"s, "=="s, "!="s, "<="s, ">="s, "None"s, "True"s, "False"s};
-        std::set<char> chars_ = {'=', '.', ',', '(', ')', '+', '-', '*', '/', '<', '>', ':'};
+        //  ,     ,    
+        std::unique_ptr<Pipeline> pipeline_;
+
+        //       tokens_.  false,     
+        bool LexMore();
+        //      Mode::Pipelined
+        void RunPipeline();
+        //      
+        Token ReceiveToken();
 
         Token ParseToken();
         Token ParseString();
         Token ParseNumber();
         Token ParseId();
         Token ParseChar();
-        Token ParseKeyWord(std::string);
         Token ParseIndent();
         Token ParseDedent();
         Token ParseNewLine();
         Token ParseComment();
+
+        //     c.  false,   
+        bool Get(char& c);
+        //   ,    ,  '\0'   
+        [[nodiscard]] char PeekChar() const;
+        //      
+        void Unget();
+        //         
+        [[nodiscard]] const char* Cursor() const;
+        [[nodiscard]] const char* End() const;
     };
 
 }  // namespace parse
\ No newline at end of file
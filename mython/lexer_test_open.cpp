@@ -1,14 +1,22 @@
 #include "lexer.h"
+#include "scan.h"
 #include "test_runner_p.h"
 
 #include <sstream>
 #include <string>
+#include <string_view>
 
 using namespace std;
 
 namespace parse {
 
     namespace {
+        //     token,   lexer
+        string StringOf(const Lexer& lexer, const Token& token) {
+            ASSERT(token.Is<token_type::String>());
+            return string(lexer.GetString(token.As<token_type::String>()));
+        }
+
         void TestSimpleAssignment() {
             istringstream input("x = 42\n"s);
             Lexer lexer(input);
@@ -69,12 +77,41 @@ namespace parse {
                 R"('word' "two words" 'long string with a double quote " inside' "another long string with single quote ' inside")"s);
             Lexer lexer(input);
 
-            ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::String{ "word"s }));
-            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{ "two words"s }));
-            ASSERT_EQUAL(lexer.NextToken(),
-                Token(token_type::String{ "long string with a double quote \" inside"s }));
-            ASSERT_EQUAL(lexer.NextToken(),
-                Token(token_type::String{ "another long string with single quote ' inside"s }));
+            ASSERT_EQUAL(StringOf(lexer, lexer.CurrentToken()), "word"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "two words"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()),
+                "long string with a double quote \" inside"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()),
+                "another long string with single quote ' inside"s);
+        }
+
+        void TestEscapedStrings() {
+            const string program = R"('it\'s' "tab\tand\nline" 'plain' "\\")"s;
+            Lexer lexer(string_view{ program });
+
+            ASSERT_EQUAL(StringOf(lexer, lexer.CurrentToken()), "it's"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "tab\tand\nline"s);
+            //   escape-     
+            const Token plain = lexer.NextToken();
+            ASSERT_EQUAL(StringOf(lexer, plain), "plain"s);
+            ASSERT(lexer.GetString(plain.As<token_type::String>()).data()
+                == program.data() + program.find("plain"sv));
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "\\"s);
+        }
+
+        void TestStringEscapes() {
+            //   escape-  ,     
+            const string program = R"('it\'s' "\"quoted\"" 'tab\there' 'back\\slash' '' 'plain' "a\nb" 'x')"s;
+            Lexer lexer(string_view{ program });
+
+            ASSERT_EQUAL(StringOf(lexer, lexer.CurrentToken()), "it's"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "\"quoted\""s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "tab\there"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "back\\slash"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), ""s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "plain"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "a\nb"s);
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "x"s);
         }
 
         void TestOperations() {
@@ -197,7 +234,7 @@ print str(p)
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "y"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
-            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{ "hello"s }));
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "hello"s);
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Class{}));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "Point"s }));
@@ -243,7 +280,7 @@ print str(p)
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "x"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ ')' }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '+' }));
-            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{ " "s }));
+            ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), " "s);
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '+' }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "str"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '(' }));
@@ -344,13 +381,149 @@ abc#
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "abc"s }));
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
-                ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{ "#"s }));
+                ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "#"s);
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
-                ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{ "#123"s }));
+                ASSERT_EQUAL(StringOf(lexer, lexer.NextToken()), "#123"s);
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
             }
         }
+
+        void TestStringViewSource() {
+            const string program = R"(class Point:
+  def __init__(x, y):
+    self.x = x # comment
+    self.y = 'y'
+
+p = Point(1, 23)
+if p.x <= 10:
+  print p.y
+)"s;
+            istringstream is(program);
+            Lexer stream_lexer(is);
+            Lexer view_lexer(string_view{ program });
+            ASSERT_EQUAL(view_lexer.CurrentToken(), stream_lexer.CurrentToken());
+            while (!stream_lexer.CurrentToken().Is<token_type::Eof>()) {
+                ASSERT_EQUAL(view_lexer.NextToken(), stream_lexer.NextToken());
+            }
+
+            //       
+            const string text = "x = 12345"s;
+            Lexer lexer(string_view(text).substr(0, 6));
+            ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{ 12 }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
+
+            Lexer unterminated("x = 'abc"sv);
+            ASSERT_EQUAL(unterminated.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_THROWS(unterminated.NextToken(), LexerError);
+        }
+
+        void TestPeekAndRewind() {
+            const string program = "x = a.b(1)\nif x:\n  print x\n"s;
+            for (const Lexer::Mode mode : { Lexer::Mode::OnDemand, Lexer::Mode::Tokenized, Lexer::Mode::Pipelined }) {
+                Lexer lexer(string_view{ program }, mode);
+
+                ASSERT_EQUAL(lexer.Peek(0), Token(token_type::Id{ "x"s }));
+                ASSERT_EQUAL(lexer.Peek(4), Token(token_type::Id{ "b"s }));
+                ASSERT_EQUAL(lexer.Peek(100), Token(token_type::Eof{}));
+                ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
+
+                const size_t start = lexer.Mark();
+                ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+                ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "a"s }));
+                const size_t middle = lexer.Mark();
+                while (!lexer.CurrentToken().Is<token_type::Eof>()) {
+                    lexer.NextToken();
+                }
+                ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
+
+                lexer.Rewind(middle);
+                ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "a"s }));
+                ASSERT_EQUAL(lexer.Peek(1), Token(token_type::Char{ '.' }));
+                lexer.Rewind(start);
+                ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
+
+                //   ,    ,    
+                istringstream input(program);
+                Lexer reference(input);
+                while (!reference.CurrentToken().Is<token_type::Eof>()) {
+                    ASSERT_EQUAL(lexer.CurrentToken(), reference.CurrentToken());
+                    lexer.NextToken();
+                    reference.NextToken();
+                }
+                ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Eof{}));
+                ASSERT_THROWS(lexer.Rewind(1000), LexerError);
+            }
+        }
+
+        void TestPipelinedLexer() {
+            string program;
+            for (int i = 0; i < 3000; ++i) {
+                program += "class C"s + to_string(i) + ":\n  def f(x):\n    return x + 'text' + 'it\\'s'  # comment\n\n"s;
+            }
+            {
+                Lexer pipelined(string_view{ program }, Lexer::Mode::Pipelined);
+                Lexer reference(string_view{ program });
+                while (!reference.CurrentToken().Is<token_type::Eof>()) {
+                    ASSERT_EQUAL(pipelined.CurrentToken(), reference.CurrentToken());
+                    if (reference.CurrentToken().Is<token_type::String>()) {
+                        ASSERT_EQUAL(StringOf(pipelined, pipelined.CurrentToken()),
+                            StringOf(reference, reference.CurrentToken()));
+                    }
+                    pipelined.NextToken();
+                    reference.NextToken();
+                }
+                ASSERT_EQUAL(pipelined.CurrentToken(), Token(token_type::Eof{}));
+            }
+            {
+                //  ,     ,    
+                Lexer abandoned(string_view{ program }, Lexer::Mode::Pipelined);
+                ASSERT_EQUAL(abandoned.CurrentToken(), Token(token_type::Class{}));
+            }
+            {
+                //       ,   
+                Lexer broken("x = 1\ny = 'unterminated"sv, Lexer::Mode::Pipelined);
+                ASSERT_EQUAL(broken.Peek(5), Token(token_type::Char{ '=' }));
+                ASSERT_THROWS(broken.Peek(6), LexerError);
+            }
+        }
+
+        void TestScanners() {
+            const scan::Isa initial_isa = scan::GetIsa();
+            for (const scan::Isa isa : { scan::Isa::Scalar, scan::Isa::Sse2, scan::Isa::Avx2 }) {
+                if (!scan::SetIsa(isa)) {
+                    continue;
+                }
+                //         16-  32- .
+                // -          
+                for (size_t run = 0; run < 70; ++run) {
+                    for (const char stop : { '\n', '\t', '(', '\xC0', '\x80', '{', '`', '@', '[', '/', ':' }) {
+                        string spaces(run, ' ');
+                        spaces += stop;
+                        spaces += "   "s;
+                        ASSERT_EQUAL(scan::CountSpaces(spaces.data(), spaces.data() + spaces.size()), run);
+                        ASSERT_EQUAL(scan::CountSpaces(spaces.data(), spaces.data() + run), run);
+
+                        string id;
+                        for (size_t i = 0; i < run; ++i) {
+                            id += "aZ09_zA"[i % 7];
+                        }
+                        const string id_with_stop = id + stop + "abc"s;
+                        ASSERT_EQUAL(scan::CountIdChars(id_with_stop.data(), id_with_stop.data() + id_with_stop.size()), run);
+                        ASSERT_EQUAL(scan::CountIdChars(id.data(), id.data() + id.size()), run);
+
+                        const string comment = string(run, '#') + "\n\n"s;
+                        ASSERT_EQUAL(scan::FindNewline(comment.data(), comment.data() + comment.size()) - comment.data(),
+                            static_cast<ptrdiff_t>(run));
+                        ASSERT(scan::FindNewline(comment.data(), comment.data() + run) == comment.data() + run);
+                    }
+                }
+            }
+            scan::SetIsa(initial_isa);
+        }
     }  // namespace
 
     void RunOpenLexerTests(TestRunner& tr) {
@@ -359,6 +532,8 @@ abc#
         RUN_TEST(tr, parse::TestNumbers);
         RUN_TEST(tr, parse::TestIds);
         RUN_TEST(tr, parse::TestStrings);
+        RUN_TEST(tr, parse::TestEscapedStrings);
+        RUN_TEST(tr, parse::TestStringEscapes);
         RUN_TEST(tr, parse::TestOperations);
         RUN_TEST(tr, parse::TestIndentsAndNewlines);
         RUN_TEST(tr, parse::TestEmptyLinesAreIgnored);
@@ -367,6 +542,10 @@ abc#
         RUN_TEST(tr, parse::TestMythonProgram);
         RUN_TEST(tr, parse::TestAlwaysEmitsNewlineAtTheEndOfNonemptyLine);
         RUN_TEST(tr, parse::TestCommentsAreIgnored);
+        RUN_TEST(tr, parse::TestStringViewSource);
+        RUN_TEST(tr, parse::TestPeekAndRewind);
+        RUN_TEST(tr, parse::TestPipelinedLexer);
+        RUN_TEST(tr, parse::TestScanners);
     }
 
 }  // namespace parse
\ No newline at end of file
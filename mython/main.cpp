@@ -1,7 +1,11 @@
-﻿#include "lexer.h"
+﻿#include "bytecode.h"
+#include "lexer.h"
 #include "parse.h"
+#include "program_cache.h"
 #include "runtime.h"
+#include "source_file.h"
 #include "statement.h"
+#include "superinstructions.h"
 #include "test_runner_p.h"
 
 #include <iostream>
@@ -14,6 +18,14 @@ namespace parse {
 
 namespace ast {
     void RunUnitTests(TestRunner& tr);
+    void RunConstantFoldingTests(TestRunner& tr);
+    void RunSuperinstructionTests(TestRunner& tr);
+}
+namespace bytecode {
+    void RunBytecodeTests(TestRunner& tr);
+}
+namespace cache {
+    void RunProgramCacheTests(TestRunner& tr);
 }
 namespace runtime {
     void RunObjectHolderTests(TestRunner& tr);
@@ -22,19 +34,69 @@ namespace runtime {
 
 void TestParseProgram(TestRunner& tr);
 
+namespace bench {
+    void RunBenchmarks(ostream& out);
+}  // namespace bench
+
 namespace {
 
-    void RunMythonProgram(istream& input, ostream& output) {
-        parse::Lexer lexer(input);
-        auto program = ParseProgram(lexer);
+    enum class Engine {
+        TreeWalker,
+        Bytecode,
+    };
+
+    const Engine ENGINES[] = { Engine::TreeWalker, Engine::Bytecode };
+
+    // Число самых частых шаблонов узлов в отчёте --node-profile
+    constexpr size_t NODE_PROFILE_LIMIT = 20;
+
+    // Если задан profile, в него записываются частоты выполнения шаблонов узлов дерева.
+    // Профилируется только обход дерева
+    void ExecuteProgram(unique_ptr<runtime::Executable> program, ostream& output, Engine engine,
+        ast::NodeProfile* profile = nullptr) {
+        if (engine == Engine::Bytecode) {
+            program = bytecode::Compile(std::move(program));
+        }
+        else {
+            program = ast::FuseSuperinstructions(std::move(program));
+            if (profile != nullptr) {
+                program = profile->Instrument(std::move(program));
+            }
+        }
 
         runtime::SimpleContext context{ output };
         runtime::Closure closure;
         program->Execute(closure, context);
     }
 
+    void PrintQuickeningStats(ostream& out) {
+        const ast::TypeFeedback::Stats& stats = ast::TypeFeedback::TotalStats();
+        out << "Quickening: specialized "sv << stats.numbers << " int-int, "sv << stats.strings << " string-string, "sv
+            << stats.instances << " instance-dunder nodes; "sv << stats.guard_hits << " specialized executions, "sv
+            << stats.deoptimizations << " deoptimizations"sv << endl;
+    }
+
+    void RunMythonProgram(parse::Lexer& lexer, ostream& output, Engine engine = Engine::TreeWalker) {
+        ExecuteProgram(ParseProgram(lexer), output, engine);
+    }
+
+    // Лексер разбирает текст скрипта без копирования в массив токенов за один проход.
+    // При parallel объявления классов разбираются на всех ядрах
+    unique_ptr<runtime::Executable> ParseScript(string_view text, bool parallel) {
+        if (parallel) {
+            return ParseProgramParallel(text);
+        }
+        parse::Lexer lexer(text, parse::Lexer::Mode::Tokenized);
+        return ParseProgram(lexer);
+    }
+
+    void RunMythonProgram(istream& input, ostream& output, Engine engine = Engine::TreeWalker) {
+        parse::Lexer lexer(input);
+        RunMythonProgram(lexer, output, engine);
+    }
+
     void TestSimplePrints() {
-        istringstream input(R"(
+        const string program = R"(
 print 57
 print 10, 24, -8
 print 'hello'
@@ -42,16 +104,19 @@ print "world"
 print True, False
 print
 print None
-)");
+)";
 
-        ostringstream output;
-        RunMythonProgram(input, output);
+        for (const Engine engine : ENGINES) {
+            istringstream input(program);
+            ostringstream output;
+            RunMythonProgram(input, output, engine);
 
-        ASSERT_EQUAL(output.str(), "57\n10 24 -8\nhello\nworld\nTrue False\n\nNone\n");
+            ASSERT_EQUAL(output.str(), "57\n10 24 -8\nhello\nworld\nTrue False\n\nNone\n");
+        }
     }
 
     void TestAssignments() {
-        istringstream input(R"(
+        const string program = R"(
 x = 57
 print x
 x = 'C++ black belt'
@@ -61,25 +126,31 @@ x = y
 print x
 x = None
 print x, y
-)");
+)";
 
-        ostringstream output;
-        RunMythonProgram(input, output);
+        for (const Engine engine : ENGINES) {
+            istringstream input(program);
+            ostringstream output;
+            RunMythonProgram(input, output, engine);
 
-        ASSERT_EQUAL(output.str(), "57\nC++ black belt\nFalse\nNone False\n");
+            ASSERT_EQUAL(output.str(), "57\nC++ black belt\nFalse\nNone False\n");
+        }
     }
 
     void TestArithmetics() {
-        istringstream input("print 1+2+3+4+5, 1*2*3*4*5, 1-2-3-4-5, 36/4/3, 2*5+10/2");
+        const string program = "print 1+2+3+4+5, 1*2*3*4*5, 1-2-3-4-5, 36/4/3, 2*5+10/2";
 
-        ostringstream output;
-        RunMythonProgram(input, output);
+        for (const Engine engine : ENGINES) {
+            istringstream input(program);
+            ostringstream output;
+            RunMythonProgram(input, output, engine);
 
-        ASSERT_EQUAL(output.str(), "15 120 -13 3 15\n");
+            ASSERT_EQUAL(output.str(), "15 120 -13 3 15\n");
+        }
     }
 
     void TestVariablesArePointers() {
-        istringstream input(R"(
+        const string program = R"(
 class Counter:
   def __init__():
     self.value = 0
@@ -103,12 +174,15 @@ d = Dummy()
 d.do_add(x)
 
 print y.value
-)");
+)";
 
-        ostringstream output;
-        RunMythonProgram(input, output);
+        for (const Engine engine : ENGINES) {
+            istringstream input(program);
+            ostringstream output;
+            RunMythonProgram(input, output, engine);
 
-        ASSERT_EQUAL(output.str(), "2\n3\n");
+            ASSERT_EQUAL(output.str(), "2\n3\n");
+        }
     }
 
     void TestAll() {
@@ -117,6 +191,10 @@ print y.value
         runtime::RunObjectHolderTests(tr);
         runtime::RunObjectsTests(tr);
         ast::RunUnitTests(tr);
+        ast::RunConstantFoldingTests(tr);
+        ast::RunSuperinstructionTests(tr);
+        bytecode::RunBytecodeTests(tr);
+        cache::RunProgramCacheTests(tr);
         TestParseProgram(tr);
 
         RUN_TEST(tr, TestSimplePrints);
@@ -127,11 +205,77 @@ print y.value
 
 }  // namespace
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
         TestAll();
-
-        RunMythonProgram(cin, cout);
+        // Статистика специализации относится только к выполняемой программе
+        ast::TypeFeedback::TotalStats() = {};
+
+        Engine engine = Engine::TreeWalker;
+        bool parallel_parse = false;
+        bool quickening_stats = false;
+        bool node_profile = false;
+        string cache_dir;
+        string script_path;
+        for (int i = 1; i < argc; ++i) {
+            if (argv[i] == "--bench"sv) {
+                bench::RunBenchmarks(cerr);
+                return 0;
+            }
+            if (argv[i] == "--engine=bytecode"sv) {
+                engine = Engine::Bytecode;
+            }
+            else if (argv[i] == "--engine=ast"sv) {
+                engine = Engine::TreeWalker;
+            }
+            else if (argv[i] == "--parallel-parse"sv) {
+                parallel_parse = true;
+            }
+            else if (argv[i] == "--quickening-stats"sv) {
+                quickening_stats = true;
+            }
+            else if (argv[i] == "--node-profile"sv) {
+                node_profile = true;
+            }
+            else if (const string_view arg = argv[i]; arg.substr(0, "--cache-dir="sv.size()) == "--cache-dir="sv) {
+                cache_dir = arg.substr("--cache-dir="sv.size());
+            }
+            else if (argv[i][0] != '-' && script_path.empty()) {
+                script_path = argv[i];
+            }
+            else {
+                throw invalid_argument("Unknown argument: "s + argv[i]);
+            }
+        }
+
+        ast::NodeProfile profile;
+        ast::NodeProfile* const profile_ptr = node_profile ? &profile : nullptr;
+        if (script_path.empty()) {
+            parse::Lexer lexer(cin);
+            ExecuteProgram(ParseProgram(lexer), cout, engine, profile_ptr);
+        }
+        else {
+            const parse::SourceFile source(script_path);
+            const string_view text = source.GetText();
+            // Если текст скрипта не менялся, разобранная программа загружается из кэша
+            unique_ptr<runtime::Executable> program;
+            if (!cache_dir.empty()) {
+                program = cache::ProgramCache(cache_dir).Load(text);
+            }
+            if (program == nullptr) {
+                program = ParseScript(text, parallel_parse);
+                if (!cache_dir.empty()) {
+                    cache::ProgramCache(cache_dir).Store(text, *program);
+                }
+            }
+            ExecuteProgram(std::move(program), cout, engine, profile_ptr);
+        }
+        if (quickening_stats) {
+            PrintQuickeningStats(cerr);
+        }
+        if (node_profile) {
+            profile.Report(cerr, NODE_PROFILE_LIMIT);
+        }
     }
     catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
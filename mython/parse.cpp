@@ -1,8 +1,16 @@
 #include "parse.h"
 
+#include "constant_folding.h"
 #include "lexer.h"
 #include "statement.h"
 
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
 using namespace std;
 
 namespace TokenType = parse::token_type;
@@ -17,10 +25,33 @@ namespace {
         return !(token == c);
     }
 
+    //     ,      
+    struct ChunkLinks {
+        struct ClassEntry {
+            runtime::ObjectHolder cls;
+            //   ,   
+            optional<runtime::Symbol> base;
+        };
+
+        struct InstanceEntry {
+            ast::NewInstance* node;
+            runtime::Symbol class_name;
+            // ,    ,  nullptr
+            const runtime::Class* cls;
+        };
+
+        //     
+        vector<ClassEntry> classes;
+        vector<InstanceEntry> instances;
+    };
+
     class Parser {
     public:
-        explicit Parser(parse::Lexer& lexer)
-            : lexer_(lexer) {
+        //   links,          
+        // ,    links        
+        explicit Parser(parse::Lexer& lexer, ChunkLinks* links = nullptr)
+            : lexer_(lexer)
+            , links_(links) {
         }
 
         // Program -> eps
@@ -34,6 +65,15 @@ namespace {
             return result;
         }
 
+        //     
+        vector<unique_ptr<ast::Statement>> ParseStatements() {
+            vector<unique_ptr<ast::Statement>> result;
+            while (!lexer_.CurrentToken().Is<TokenType::Eof>()) {
+                result.push_back(ParseStatement());
+            }
+            return result;
+        }
+
     private:
         // Suite -> NEWLINE INDENT (Statement)+ DEDENT
         unique_ptr<ast::Statement> ParseSuite()  // NOLINT
@@ -76,7 +116,16 @@ namespace {
                 lexer_.ExpectNext<TokenType::Char>(':');
                 lexer_.NextToken();
 
+                // self         
+                MethodScope scope;
+                scope.slots[runtime::Symbol("self"sv)] = 0;
+                for (const runtime::Symbol param : m.formal_params) {
+                    scope.slots[param] = scope.frame_size++;
+                }
+                MethodScope* outer_scope = std::exchange(scope_, &scope);
                 m.body = std::make_unique<ast::MethodBody>(ParseSuite());  // NOLINT
+                scope_ = outer_scope;
+                m.frame_size = scope.frame_size;
 
                 result.push_back(std::move(m));
             }
@@ -86,21 +135,25 @@ namespace {
         // ClassDefinition -> Id ['(' Id ')'] : new_line indent MethodList dedent
         unique_ptr<ast::Statement> ParseClassDefinition()  // NOLINT
         {
-            string class_name = lexer_.Expect<TokenType::Id>().value;
+            string class_name = lexer_.Expect<TokenType::Id>().value.GetName();
 
             lexer_.NextToken();
 
             const runtime::Class* base_class = nullptr;
+            optional<runtime::Symbol> base_name;
             if (lexer_.CurrentToken() == '(') {
-                auto name = lexer_.ExpectNext<TokenType::Id>().value;
+                const runtime::Symbol name = lexer_.ExpectNext<TokenType::Id>().value;
                 lexer_.ExpectNext<TokenType::Char>(')');
                 lexer_.NextToken();
 
                 auto it = declared_classes_.find(name);
-                if (it == declared_classes_.end()) {
-                    throw ParseError("Base class "s + name + " not found for class "s + class_name);
+                if (it != declared_classes_.end()) {
+                    base_class = static_cast<const runtime::Class*>(it->second.Get());  // NOLINT
                 }
-                base_class = static_cast<const runtime::Class*>(it->second.Get());  // NOLINT
+                else if (links_ == nullptr) {
+                    throw ParseError("Base class "s + name.GetName() + " not found for class "s + class_name);
+                }
+                base_name = name;
             }
 
             lexer_.Expect<TokenType::Char>(':');
@@ -120,12 +173,33 @@ namespace {
             if (!inserted) {
                 throw ParseError("Class "s + class_name + " already exists"s);
             }
+            if (links_ != nullptr) {
+                links_->classes.push_back({ it->second, base_name });
+            }
 
             return make_unique<ast::ClassDefinition>(it->second);
         }
 
-        vector<string> ParseDottedIds() {
-            vector<string> result(1, lexer_.Expect<TokenType::Id>().value);
+        //       name,      .
+        //      Closure
+        size_t ResolveSlot(runtime::Symbol name) {
+            if (scope_ == nullptr) {
+                return ast::NO_SLOT;
+            }
+            auto [it, inserted] = scope_->slots.emplace(name, scope_->frame_size);
+            if (inserted) {
+                ++scope_->frame_size;
+            }
+            return it->second;
+        }
+
+        ast::VariableValue MakeVariable(vector<runtime::Symbol> dotted_ids) {
+            const size_t slot = ResolveSlot(dotted_ids.front());
+            return ast::VariableValue(std::move(dotted_ids), slot);
+        }
+
+        vector<runtime::Symbol> ParseDottedIds() {
+            vector<runtime::Symbol> result(1, lexer_.Expect<TokenType::Id>().value);
 
             while (lexer_.NextToken() == '.') {
                 result.push_back(lexer_.ExpectNext<TokenType::Id>().value);
@@ -139,24 +213,25 @@ namespace {
         unique_ptr<ast::Statement> ParseAssignmentOrCall() {
             lexer_.Expect<TokenType::Id>();
 
-            vector<string> id_list = ParseDottedIds();
-            string last_name = id_list.back();
+            vector<runtime::Symbol> id_list = ParseDottedIds();
+            const runtime::Symbol last_name = id_list.back();
             id_list.pop_back();
 
             if (lexer_.CurrentToken() == '=') {
                 lexer_.NextToken();
 
                 if (id_list.empty()) {
-                    return make_unique<ast::Assignment>(std::move(last_name), ParseTest());
+                    const size_t slot = ResolveSlot(last_name);
+                    return make_unique<ast::Assignment>(last_name, slot, ParseTest());
                 }
-                return make_unique<ast::FieldAssignment>(ast::VariableValue{ std::move(id_list) },
-                    std::move(last_name), ParseTest());
+                return make_unique<ast::FieldAssignment>(MakeVariable(std::move(id_list)),
+                    last_name, ParseTest());
             }
             lexer_.Expect<TokenType::Char>('(');
             lexer_.NextToken();
 
             if (id_list.empty()) {
-                throw ParseError("Mython doesn't support functions, only methods: "s + last_name);
+                throw ParseError("Mython doesn't support functions, only methods: "s + last_name.GetName());
             }
 
             vector<unique_ptr<ast::Statement>> args;
@@ -166,8 +241,8 @@ namespace {
             lexer_.Expect<TokenType::Char>(')');
             lexer_.NextToken();
 
-            return make_unique<ast::MethodCall>(make_unique<ast::VariableValue>(std::move(id_list)),
-                std::move(last_name), std::move(args));
+            return make_unique<ast::MethodCall>(make_unique<ast::VariableValue>(MakeVariable(std::move(id_list))),
+                last_name, std::move(args));
         }
 
         // Expr -> Adder ['+'/'-' Adder]*
@@ -234,7 +309,7 @@ namespace {
                 return make_unique<ast::NumericConst>(result);
             }
             if (const auto* str = lexer_.CurrentToken().TryAs<TokenType::String>()) {
-                string result = str->value;
+                string result(lexer_.GetString(*str));
                 lexer_.NextToken();
                 return make_unique<ast::StringConst>(std::move(result));
             }
@@ -255,7 +330,7 @@ namespace {
         }
 
         std::unique_ptr<ast::Statement> ParseDottedIdsInMultExpr() {
-            vector<string> names = ParseDottedIds();
+            vector<runtime::Symbol> names = ParseDottedIds();
 
             if (lexer_.CurrentToken() == '(') {
                 // various calls
@@ -266,27 +341,37 @@ namespace {
                 lexer_.Expect<TokenType::Char>(')');
                 lexer_.NextToken();
 
-                auto method_name = names.back();
+                const runtime::Symbol method_name = names.back();
                 names.pop_back();
 
                 if (!names.empty()) {
                     return make_unique<ast::MethodCall>(
-                        make_unique<ast::VariableValue>(std::move(names)), std::move(method_name),
+                        make_unique<ast::VariableValue>(MakeVariable(std::move(names))), method_name,
                         std::move(args));
                 }
                 if (auto it = declared_classes_.find(method_name); it != declared_classes_.end()) {
-                    return make_unique<ast::NewInstance>(
-                        static_cast<const runtime::Class&>(*it->second), std::move(args));  // NOLINT
+                    const auto& cls = static_cast<const runtime::Class&>(*it->second);  // NOLINT
+                    auto result = make_unique<ast::NewInstance>(cls, std::move(args));
+                    if (links_ != nullptr) {
+                        links_->instances.push_back({ result.get(), method_name, &cls });
+                    }
+                    return result;
                 }
-                if (method_name == "str"sv) {
+                if (method_name.GetName() == "str"sv) {
                     if (args.size() != 1) {
                         throw ParseError("Function str takes exactly one argument"s);
                     }
                     return make_unique<ast::Stringify>(std::move(args.front()));
                 }
-                throw ParseError("Unknown call to "s + method_name + "()"s);
+                if (links_ != nullptr) {
+                    //         
+                    auto result = make_unique<ast::NewInstance>(std::move(args));
+                    links_->instances.push_back({ result.get(), method_name, nullptr });
+                    return result;
+                }
+                throw ParseError("Unknown call to "s + method_name.GetName() + "()"s);
             }
-            return make_unique<ast::VariableValue>(std::move(names));
+            return make_unique<ast::VariableValue>(MakeVariable(std::move(names)));
         }
 
         vector<unique_ptr<ast::Statement>> ParseTestList()  // NOLINT
@@ -367,33 +452,27 @@ namespace {
 
             if (tok == '<') {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Less, std::move(result),
-                    ParseExpression());
+                return ast::MakeComparison(runtime::CompareOp::Less, std::move(result), ParseExpression());
             }
             if (tok == '>') {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Greater, std::move(result),
-                    ParseExpression());
+                return ast::MakeComparison(runtime::CompareOp::Greater, std::move(result), ParseExpression());
             }
             if (tok.Is<TokenType::Eq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Equal, std::move(result),
-                    ParseExpression());
+                return ast::MakeComparison(runtime::CompareOp::Equal, std::move(result), ParseExpression());
             }
             if (tok.Is<TokenType::NotEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::NotEqual, std::move(result),
-                    ParseExpression());
+                return ast::MakeComparison(runtime::CompareOp::NotEqual, std::move(result), ParseExpression());
             }
             if (tok.Is<TokenType::LessOrEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::LessOrEqual, std::move(result),
-                    ParseExpression());
+                return ast::MakeComparison(runtime::CompareOp::LessOrEqual, std::move(result), ParseExpression());
             }
             if (tok.Is<TokenType::GreaterOrEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::GreaterOrEqual, std::move(result),
-                    ParseExpression());
+                return ast::MakeComparison(runtime::CompareOp::GreaterOrEqual, std::move(result), ParseExpression());
             }
             return result;
         }
@@ -439,12 +518,150 @@ namespace {
             return ParseAssignmentOrCall();
         }
 
+        //    
+        struct MethodScope {
+            unordered_map<runtime::Symbol, size_t> slots;
+            size_t frame_size = 1;
+        };
+
         parse::Lexer& lexer_;
+        ChunkLinks* links_;
         runtime::Closure declared_classes_;
+        //      nullptr  
+        MethodScope* scope_ = nullptr;
     };
 
+    //    :     
+    //         
+    void LinkChunks(vector<ChunkLinks>& chunks) {
+        runtime::Closure classes;
+        for (ChunkLinks& chunk : chunks) {
+            //    ,   
+            for (auto& instance : chunk.instances) {
+                if (instance.cls != nullptr) {
+                    continue;
+                }
+                auto it = classes.find(instance.class_name);
+                if (it == classes.end()) {
+                    throw ParseError("Unknown call to "s + instance.class_name.GetName() + "()"s);
+                }
+                instance.cls = it->second.TryAs<runtime::Class>();
+            }
+            for (const auto& entry : chunk.classes) {
+                auto* cls = entry.cls.TryAs<runtime::Class>();
+                if (entry.base) {
+                    const runtime::Class* parent = cls->GetParent();
+                    if (parent == nullptr) {
+                        auto it = classes.find(*entry.base);
+                        if (it == classes.end()) {
+                            throw ParseError("Base class "s + entry.base->GetName() + " not found for class "s + cls->GetName());
+                        }
+                        parent = it->second.TryAs<runtime::Class>();
+                    }
+                    //    ,     
+                    cls->SetParent(parent);
+                }
+                if (!classes.emplace(cls->GetName(), entry.cls).second) {
+                    throw ParseError("Class "s + cls->GetName() + " already exists"s);
+                }
+            }
+        }
+        //  str()      ,    str  
+        if (classes.count(runtime::Symbol("str"sv)) != 0) {
+            throw ParseError("Class str shadows the built-in function"s);
+        }
+        for (const ChunkLinks& chunk : chunks) {
+            for (const auto& instance : chunk.instances) {
+                instance.node->Bind(*instance.cls);
+            }
+        }
+    }
+
+    //       target .  ,  ,
+    //   ,        
+    vector<string_view> SplitAtClasses(string_view source, size_t target) {
+        vector<string_view> result;
+        size_t begin = 0;
+        while (begin < source.size()) {
+            size_t end = source.size();
+            for (size_t pos = begin + target - 1; pos < source.size(); ++pos) {
+                pos = source.find("\nclass"sv, pos);
+                if (pos == string_view::npos) {
+                    break;
+                }
+                const size_t next = pos + "\nclass"sv.size();
+                if (next < source.size() && (source[next] == ' ' || source[next] == '\t')) {
+                    end = pos + 1;
+                    break;
+                }
+            }
+            result.push_back(source.substr(begin, end - begin));
+            begin = end;
+        }
+        return result;
+    }
+
 }  // namespace
 
 unique_ptr<runtime::Executable> ParseProgram(parse::Lexer& lexer) {
-    return Parser{ lexer }.ParseProgram();
-}
\ No newline at end of file
+    return ast::FoldConstants(Parser{ lexer }.ParseProgram());
+}
+
+unique_ptr<runtime::Executable> ParseProgramParallel(string_view source, size_t thread_count, size_t min_chunk_size) {
+    const auto parse_sequential = [source] {
+        parse::Lexer lexer(source);
+        return ParseProgram(lexer);
+    };
+
+    if (thread_count == 0) {
+        thread_count = max(thread::hardware_concurrency(), 1U);
+    }
+    //      ,   
+    const size_t target = max(min_chunk_size, source.size() / (thread_count * 4) + 1);
+    const vector<string_view> chunks = SplitAtClasses(source, target);
+    if (thread_count == 1 || chunks.size() < 2) {
+        return parse_sequential();
+    }
+
+    vector<vector<unique_ptr<ast::Statement>>> statements(chunks.size());
+    vector<ChunkLinks> links(chunks.size());
+    atomic<size_t> next_chunk = 0;
+    atomic<bool> failed = false;
+    const auto worker = [&] {
+        for (size_t i = next_chunk++; i < chunks.size() && !failed; i = next_chunk++) {
+            try {
+                parse::Lexer lexer(chunks[i]);
+                statements[i] = Parser{ lexer, &links[i] }.ParseStatements();
+            }
+            catch (...) {
+                failed = true;
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t i = 1; i < min(thread_count, chunks.size()); ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    if (!failed) {
+        try {
+            LinkChunks(links);
+            auto result = make_unique<ast::Compound>();
+            for (auto& chunk : statements) {
+                for (auto& statement : chunk) {
+                    result->AddStatement(std::move(statement));
+                }
+            }
+            return ast::FoldConstants(std::move(result));
+        }
+        catch (const ParseError&) {
+        }
+    }
+    //    ,      ParseProgram
+    return parse_sequential();
+}
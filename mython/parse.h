@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
+#include <string_view>
 
 namespace parse {
     class Lexer;
@@ -15,4 +17,13 @@ struct ParseError : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
-std::unique_ptr<runtime::Executable> ParseProgram(parse::Lexer& lexer);
\ No newline at end of file
+std::unique_ptr<runtime::Executable> ParseProgram(parse::Lexer& lexer);
+
+/*
+ *   source .      , 
+ *   ,     min_chunk_size   thread_count 
+ * (0    ).           .
+ *        ParseProgram
+ */
+std::unique_ptr<runtime::Executable> ParseProgramParallel(std::string_view source,
+    size_t thread_count = 0, size_t min_chunk_size = 64 * 1024);
@@ -1,3 +1,4 @@
+#include "bytecode.h"
 #include "lexer.h"
 #include "parse.h"
 #include "statement.h"
@@ -7,10 +8,22 @@ using namespace std;
 
 namespace parse {
 
-    unique_ptr<ast::Statement> ParseProgramFromString(const string& program) {
+    enum class Engine {
+        TreeWalker,
+        Bytecode,
+    };
+
+    const Engine ENGINES[] = { Engine::TreeWalker, Engine::Bytecode };
+
+    unique_ptr<ast::Statement> ParseProgramFromString(const string& program,
+        Engine engine = Engine::TreeWalker) {
         istringstream is(program);
         parse::Lexer lexer(is);
-        return ParseProgram(lexer);
+        auto tree = ParseProgram(lexer);
+        if (engine == Engine::Bytecode) {
+            return bytecode::Compile(std::move(tree));
+        }
+        return tree;
     }
 
     void TestSimpleProgram() {
@@ -22,13 +35,15 @@ n = "world"
 print x + y, z + n
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        ASSERT_EQUAL(context.output.str(), "9 hello, world\n"s);
+            ASSERT_EQUAL(context.output.str(), "9 hello, world\n"s);
+        }
     }
 
     void TestProgramWithClasses() {
@@ -60,13 +75,15 @@ far_far_away = Point(10000, 50000)
 print program_name, origin, far_far_away, origin.SetX(1)
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        ASSERT_EQUAL(context.output.str(), "Classes test (0; 0) (10000; 50000) None\n"s);
+            ASSERT_EQUAL(context.output.str(), "Classes test (0; 0) (10000; 50000) None\n"s);
+        }
     }
 
     void TestProgramWithIf() {
@@ -86,13 +103,15 @@ else:
   print 'x <= 0'
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        ASSERT_EQUAL(context.output.str(), "x <= y\ny >= 0\n"s);
+            ASSERT_EQUAL(context.output.str(), "x <= y\ny >= 0\n"s);
+        }
     }
 
     void TestReturnFromIf() {
@@ -108,13 +127,15 @@ x = Abs()
 print x.calc(2)
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        ASSERT_EQUAL(context.output.str(), "2\n"s);
+            ASSERT_EQUAL(context.output.str(), "2\n"s);
+        }
     }
 
     void TestRecursion() {
@@ -135,13 +156,15 @@ x.calc(10)
 print x.result
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        ASSERT_EQUAL(context.output.str(), "55\n"s);
+            ASSERT_EQUAL(context.output.str(), "55\n"s);
+        }
     }
 
     void TestRecursion2() {
@@ -164,13 +187,15 @@ print x.calc(22, 17)
 print x.call_count
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        ASSERT_EQUAL(context.output.str(), "17\n1\n115\n"s);
+            ASSERT_EQUAL(context.output.str(), "17\n1\n115\n"s);
+        }
     }
 
     void TestComplexLogicalExpression() {
@@ -182,13 +207,15 @@ ok = a + b > c and a + c > b and b + c > a
 print ok
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        ASSERT_EQUAL(context.output.str(), "False\n"s);
+            ASSERT_EQUAL(context.output.str(), "False\n"s);
+        }
     }
 
     void TestClassicalPolymorphism() {
@@ -234,14 +261,177 @@ t2 = Triangle(125, 1, 2)
 print r, c, t1, t2
 )"s;
 
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
+
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
+
+            ASSERT_EQUAL(context.output.str(),
+                "Rect(10x20) Circle(52) Triangle(3, 4, 5) Wrong triangle\n"s);
+        }
+    }
+
+    void TestMissingMethodSkipsArguments() {
+        const string program = R"(
+class A:
+  def f(n):
+    if n < 0:
+      print 'neg'
+    return n
+
+class B:
+  def g():
+    return 1
+
+a = A()
+b = B()
+print b.missing(a.f(0 - 1))
+print b.g(a.f(0 - 1))
+print b.g(), a.f(2)
+)"s;
+
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
+
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
+            //   ,           
+            ASSERT_EQUAL(context.output.str(), "None\nNone\n1 2\n"s);
+        }
 
-        ASSERT_EQUAL(context.output.str(),
-            "Rect(10x20) Circle(52) Triangle(3, 4, 5) Wrong triangle\n"s);
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
+
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program + "x = 1\nx.f(a.f(0 - 1))\n"s, engine);
+            ASSERT_THROWS(tree->Execute(closure, context), runtime_error);
+            ASSERT_EQUAL(context.output.str(), "None\nNone\n1 2\n"s);
+        }
+    }
+
+    void TestPolymorphicCallSiteCache() {
+        const string program = R"(
+class Shape:
+  def area():
+    return 0
+
+class Rect(Shape):
+  def __init__(w, h):
+    self.w = w
+    self.h = h
+
+  def area():
+    return self.w * self.h
+
+class Square(Rect):
+  def __init__(a):
+    self.w = a
+    self.h = a
+
+class Circle(Shape):
+  def __init__(r):
+    self.r = r
+
+  def area():
+    return 3 * self.r * self.r
+
+class Total:
+  def __init__():
+    self.value = 0
+
+  def add(shape):
+    self.value = self.value + shape.area()
+
+  def repeat(n, a, b, c):
+    if n > 0:
+      self.add(a)
+      self.add(b)
+      self.add(c)
+      self.repeat(n - 1, a, b, c)
+
+total = Total()
+total.repeat(10, Rect(2, 3), Square(2), Circle(1))
+print total.value
+)"s;
+
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
+
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            const runtime::MethodCache::Stats before = runtime::MethodCache::TotalStats();
+            tree->Execute(closure, context);
+            const runtime::MethodCache::Stats& after = runtime::MethodCache::TotalStats();
+
+            ASSERT_EQUAL(context.output.str(), "130\n"s);
+            //          :
+            // shape.area()   ,     
+            ASSERT_EQUAL(after.misses - before.misses, 8U);
+            // 11  repeat, 30  add  30  area
+            ASSERT_EQUAL(after.hits - before.hits, 71U - 8U);
+        }
+    }
+
+    void TestMethodLocals() {
+        const string program = R"(
+class Point:
+  def __init__(x, y):
+    self.x = x
+    self.y = y
+
+class Locals:
+  def many(a, b, c, d, e):
+    f = a + b
+    g = f + c
+    h = g + d
+    i = h + e
+    nothing = None
+    if nothing == None:
+      j = i * 2
+    return j
+
+  def nested(n):
+    result = n
+    other = self.many(1, 2, 3, 4, 5)
+    point = Point(n, other)
+    return result + point.y
+
+  def undefined():
+    return missing
+
+  def assign_then_read(flag):
+    if flag:
+      value = 'assigned'
+    return value
+
+locals = Locals()
+print locals.many(1, 1, 1, 1, 1), locals.nested(7), locals.assign_then_read(True)
+)"s;
+
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
+
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
+
+            ASSERT_EQUAL(context.output.str(), "10 37 assigned\n"s);
+            ASSERT(closure.count("locals"s) == 1 && closure.count("result"s) == 0);
+            ASSERT(context.GetFrame() == nullptr);
+            // self,      
+            const auto* cls = closure.at("Locals"s).TryAs<runtime::Class>();
+            ASSERT_EQUAL(cls->GetMethod("many"s)->frame_size, 12U);
+
+            auto* locals = closure.at("locals"s).TryAs<runtime::ClassInstance>();
+            ASSERT_THROWS(locals->Call("undefined"s, {}, context), runtime_error);
+            ASSERT_THROWS(locals->Call("assign_then_read"s, { runtime::ObjectHolder::Own(runtime::Bool(false)) },
+                context), runtime_error);
+            ASSERT(context.GetFrame() == nullptr);
+        }
     }
 
     void TestSelf() {
@@ -257,12 +447,99 @@ class XHolder:
 xh = XHolder()
 x = X(xh)
 )";
-        runtime::DummyContext context;
+        for (const Engine engine : ENGINES) {
+            runtime::DummyContext context;
+
+            runtime::Closure closure;
+            auto tree = ParseProgramFromString(program, engine);
+            tree->Execute(closure, context);
+            cout << context.output.str();
+        }
+    }
+
+    //          
+    template <typename Parse>
+    string ParseErrorMessage(Parse parse) {
+        try {
+            parse();
+        }
+        catch (const runtime_error& e) {
+            return e.what();
+        }
+        return {};
+    }
+
+    void TestParallelParse() {
+        //       
+        const string program = R"(
+class Shape:
+  def __init__(name):
+    self.name = name
+
+  def __str__():
+    return self.name + ' ' + str(self.area())
+
+  def area():
+    return 0
+
+class Rect(Shape):
+  def __init__(w, h):
+    self.name = 'rect'
+    self.w = w
+    self.h = h
+
+  def area():
+    return self.w * self.h
+
+class Square(Rect):
+  def __init__(a):
+    self.name = 'square'
+    self.w = a
+    self.h = a
+
+class Named(Shape):
+  def make():
+    return Square(3)
+
+named = Named('named')
+print Rect(2, 5), Square(4), named, named.make()
+)"s;
 
-        runtime::Closure closure;
-        auto tree = ParseProgramFromString(program);
-        tree->Execute(closure, context);
-        cout << context.output.str();
+        for (const size_t thread_count : { 1U, 2U, 4U }) {
+            for (const Engine engine : ENGINES) {
+                auto tree = ParseProgramParallel(program, thread_count, 1);
+                if (engine == Engine::Bytecode) {
+                    tree = bytecode::Compile(std::move(tree));
+                }
+                runtime::DummyContext context;
+                runtime::Closure closure;
+                tree->Execute(closure, context);
+
+                ASSERT_EQUAL(context.output.str(), "rect 10 square 16 named 0 square 9\n"s);
+                const auto* square = closure.at("Square"s).TryAs<runtime::Class>();
+                ASSERT(square->GetParent() == closure.at("Rect"s).TryAs<runtime::Class>());
+            }
+        }
+
+        //      
+        const string invalid_programs[] = {
+            "class A(B):\n  def f():\n    return 1\nclass B:\n  def f():\n    return 2\n"s,
+            "class A:\n  def f():\n    return B()\nclass B:\n  def f():\n    return 2\n"s,
+            "class A:\n  def f():\n    return 1\nclass A:\n  def f():\n    return 2\n"s,
+            "class str:\n  def f():\n    return 1\nclass B:\n  def f():\n    return str(1)\n"s,
+            "x = 1\nclass A:\n  def f()\n    return 1\n"s,
+        };
+        for (const string& invalid : invalid_programs) {
+            const string expected = ParseErrorMessage([&invalid] {
+                istringstream is(invalid);
+                parse::Lexer lexer(is);
+                ParseProgram(lexer);
+            });
+            const string actual = ParseErrorMessage([&invalid] {
+                ParseProgramParallel(invalid, 4, 1);
+            });
+            ASSERT_EQUAL(actual, expected);
+        }
     }
 
 }  // namespace parse
@@ -276,5 +553,9 @@ void TestParseProgram(TestRunner& tr) {
     RUN_TEST(tr, parse::TestRecursion2);
     RUN_TEST(tr, parse::TestComplexLogicalExpression);
     RUN_TEST(tr, parse::TestClassicalPolymorphism);
+    RUN_TEST(tr, parse::TestMissingMethodSkipsArguments);
+    RUN_TEST(tr, parse::TestPolymorphicCallSiteCache);
+    RUN_TEST(tr, parse::TestMethodLocals);
     RUN_TEST(tr, parse::TestSelf);
+    RUN_TEST(tr, parse::TestParallelParse);
 }
\ No newline at end of file
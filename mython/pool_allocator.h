@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace runtime {
+
+    namespace detail {
+
+        //   ,   .      
+        inline constexpr size_t MAX_POOLED_BLOCK_SIZE = 256;
+        //    ,   operator new
+        inline constexpr size_t POOL_GRANULARITY = alignof(std::max_align_t);
+        //  ,    
+        inline constexpr size_t BLOCKS_PER_SLAB = 256;
+
+        constexpr size_t RoundUpToGranularity(size_t size) {
+            return (size + POOL_GRANULARITY - 1) / POOL_GRANULARITY * POOL_GRANULARITY;
+        }
+
+        //    size .      :
+        //          
+        inline std::byte* AllocateSlab(size_t size) {
+            static std::mutex mutex;
+            //    ,     ,
+            //     
+            static auto* slabs = new std::vector<std::unique_ptr<std::byte[]>>();
+
+            auto slab = std::make_unique<std::byte[]>(size);
+            std::byte* result = slab.get();
+            std::lock_guard guard(mutex);
+            slabs->push_back(std::move(slab));
+            return result;
+        }
+
+        //    .       ,
+        //       .   
+        //       ,      
+        template <size_t BlockSize>
+        class SizeClassPool {
+        public:
+            static_assert(BlockSize % POOL_GRANULARITY == 0 && BlockSize <= MAX_POOLED_BLOCK_SIZE);
+
+            static void* Allocate() {
+                if (ThreadExited()) {
+                    // ,    thread_local,     
+                    SharedFreeList& shared = Shared();
+                    std::lock_guard guard(shared.mutex);
+                    if (shared.head == nullptr) {
+                        shared.head = CarveSlab();
+                    }
+                    Node* node = shared.head;
+                    shared.head = node->next;
+                    return node;
+                }
+                Node*& head = FreeList();
+                if (head == nullptr) {
+                    head = Refill();
+                }
+                Node* node = head;
+                head = node->next;
+                return node;
+            }
+
+            static void Deallocate(void* block) noexcept {
+                auto* node = static_cast<Node*>(block);
+                if (ThreadExited()) {
+                    Release(node);
+                    return;
+                }
+                Node*& head = FreeList();
+                node->next = head;
+                head = node;
+            }
+
+        private:
+            struct Node {
+                Node* next;
+            };
+
+            struct SharedFreeList {
+                std::mutex mutex;
+                Node* head = nullptr;
+            };
+
+            //          
+            struct FreeListOwner {
+                ~FreeListOwner() {
+                    Release(FreeList());
+                    FreeList() = nullptr;
+                    ThreadExited() = true;
+                }
+            };
+
+            static Node*& FreeList() {
+                thread_local Node* head = nullptr;
+                return head;
+            }
+
+            static bool& ThreadExited() {
+                thread_local bool exited = false;
+                return exited;
+            }
+
+            static SharedFreeList& Shared() {
+                //    ,     
+                static auto* shared = new SharedFreeList();
+                return *shared;
+            }
+
+            //    list    
+            static void Release(Node* list) noexcept {
+                if (list == nullptr) {
+                    return;
+                }
+                Node* tail = list;
+                while (tail->next != nullptr) {
+                    tail = tail->next;
+                }
+                SharedFreeList& shared = Shared();
+                std::lock_guard guard(shared.mutex);
+                tail->next = shared.head;
+                shared.head = list;
+            }
+
+            //    ,    ,   
+            static Node* Refill() {
+                thread_local FreeListOwner owner;
+                (void)owner;
+                {
+                    SharedFreeList& shared = Shared();
+                    std::lock_guard guard(shared.mutex);
+                    if (shared.head != nullptr) {
+                        return std::exchange(shared.head, nullptr);
+                    }
+                }
+                return CarveSlab();
+            }
+
+            //         
+            static Node* CarveSlab() {
+                std::byte* slab = AllocateSlab(BlockSize * BLOCKS_PER_SLAB);
+                Node* head = nullptr;
+                for (size_t i = BLOCKS_PER_SLAB; i-- > 0;) {
+                    auto* node = new (slab + i * BlockSize) Node{ head };
+                    head = node;
+                }
+                return head;
+            }
+        };
+
+        //  ,  PoolAllocator   
+        inline size_t& AllocationCount() {
+            thread_local size_t count = 0;
+            return count;
+        }
+
+    }  // namespace detail
+
+    /*
+     * ,        .
+     *   std::allocate_shared,     ,   .
+     *       operator new
+     */
+    template <typename T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+
+        PoolAllocator() = default;
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>& /*other*/) noexcept {  // NOLINT(google-explicit-constructor)
+        }
+
+        [[nodiscard]] T* allocate(size_t n) {
+            ++detail::AllocationCount();
+            if constexpr (IS_POOLED) {
+                if (n == 1) {
+                    return static_cast<T*>(Pool::Allocate());
+                }
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            if constexpr (IS_POOLED) {
+                if (n == 1) {
+                    Pool::Deallocate(p);
+                    return;
+                }
+            }
+            ::operator delete(p);
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U>& /*other*/) const noexcept {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const PoolAllocator<U>& /*other*/) const noexcept {
+            return false;
+        }
+
+    private:
+        static constexpr size_t BLOCK_SIZE = detail::RoundUpToGranularity(sizeof(T));
+        static constexpr bool IS_POOLED = BLOCK_SIZE <= detail::MAX_POOLED_BLOCK_SIZE
+            && alignof(T) <= detail::POOL_GRANULARITY;
+
+        using Pool = detail::SizeClassPool<IS_POOLED ? BLOCK_SIZE : detail::POOL_GRANULARITY>;
+    };
+
+    //   ,  PoolAllocator   ,     operator new.
+    //  ,       
+    inline size_t GetPoolAllocationCount() {
+        return detail::AllocationCount();
+    }
+
+}  // namespace runtime
@@ -0,0 +1,627 @@
+#include "program_cache.h"
+
+#include "source_file.h"
+#include "statement.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <typeinfo>
+#include <unordered_map>
+
+using namespace std;
+
+namespace cache {
+
+    namespace {
+
+        //    
+        constexpr string_view MAGIC = "MYTHONC\0"sv;
+        //             Closure
+        constexpr uint32_t NO_INDEX = static_cast<uint32_t>(-1);
+
+        enum class NodeTag : uint8_t {
+            Null,
+            NumericConst,
+            StringConst,
+            BoolConst,
+            None,
+            VariableValue,
+            Assignment,
+            FieldAssignment,
+            Print,
+            MethodCall,
+            NewInstance,
+            Stringify,
+            Not,
+            Add,
+            Sub,
+            Mult,
+            Div,
+            Or,
+            And,
+            Comparison,
+            Compound,
+            MethodBody,
+            Return,
+            ClassDefinition,
+            IfElse,
+        };
+
+        //     runtime::CompareOp
+        constexpr uint8_t COMPARE_OP_COUNT = static_cast<uint8_t>(runtime::CompareOp::GreaterOrEqual) + 1;
+
+        //  :  hash    
+        uint64_t Fnv1a(string_view data, uint64_t hash = 14695981039346656037ULL) {
+            for (const char c : data) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+    }  // namespace
+
+    //       .  
+    //   ,       
+    class Writer {
+    public:
+        string Finish() {
+            return std::move(out_);
+        }
+
+        void WriteHeader() {
+            out_ += MAGIC;
+            WriteString(INTERPRETER_VERSION);
+        }
+
+        void WriteNode(const runtime::Executable* node) {
+            if (node == nullptr) {
+                WriteTag(NodeTag::Null);
+            }
+            else if (const auto* p = dynamic_cast<const ast::NumericConst*>(node)) {
+                WriteTag(NodeTag::NumericConst);
+                WriteInt(static_cast<uint32_t>(p->GetValue().GetValue()));
+            }
+            else if (const auto* p = dynamic_cast<const ast::StringConst*>(node)) {
+                WriteTag(NodeTag::StringConst);
+                WriteString(p->GetValue().GetValue());
+            }
+            else if (const auto* p = dynamic_cast<const ast::BoolConst*>(node)) {
+                WriteTag(NodeTag::BoolConst);
+                out_ += static_cast<char>(p->GetValue().GetValue());
+            }
+            else if (dynamic_cast<const ast::None*>(node)) {
+                WriteTag(NodeTag::None);
+            }
+            else if (const auto* p = dynamic_cast<const ast::VariableValue*>(node)) {
+                WriteTag(NodeTag::VariableValue);
+                WriteVariable(*p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::Assignment*>(node)) {
+                WriteTag(NodeTag::Assignment);
+                WriteSymbol(p->GetName());
+                WriteSlot(p->GetSlot());
+                WriteNode(&p->GetValue());
+            }
+            else if (const auto* p = dynamic_cast<const ast::FieldAssignment*>(node)) {
+                WriteTag(NodeTag::FieldAssignment);
+                WriteVariable(p->GetObject());
+                WriteSymbol(p->GetFieldName());
+                WriteNode(&p->GetValue());
+            }
+            else if (const auto* p = dynamic_cast<const ast::Print*>(node)) {
+                WriteTag(NodeTag::Print);
+                WriteNodes(p->GetArgs());
+            }
+            else if (const auto* p = dynamic_cast<const ast::MethodCall*>(node)) {
+                WriteTag(NodeTag::MethodCall);
+                WriteNode(&p->GetObject());
+                WriteSymbol(p->GetMethod());
+                WriteNodes(p->GetArgs());
+            }
+            else if (const auto* p = dynamic_cast<const ast::NewInstance*>(node)) {
+                WriteTag(NodeTag::NewInstance);
+                WriteInt(ClassIndex(p->GetClass()));
+                WriteNodes(p->GetArgs());
+            }
+            else if (const auto* p = dynamic_cast<const ast::Stringify*>(node)) {
+                WriteUnary(NodeTag::Stringify, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::Not*>(node)) {
+                WriteUnary(NodeTag::Not, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::Add*>(node)) {
+                WriteBinary(NodeTag::Add, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::Sub*>(node)) {
+                WriteBinary(NodeTag::Sub, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::Mult*>(node)) {
+                WriteBinary(NodeTag::Mult, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::Div*>(node)) {
+                WriteBinary(NodeTag::Div, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::Or*>(node)) {
+                WriteBinary(NodeTag::Or, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::And*>(node)) {
+                WriteBinary(NodeTag::And, *p);
+            }
+            else if (const auto* p = dynamic_cast<const ast::BuiltinComparison*>(node)) {
+                WriteTag(NodeTag::Comparison);
+                out_ += static_cast<char>(p->GetOp());
+                WriteNode(&p->GetLhs());
+                WriteNode(&p->GetRhs());
+            }
+            else if (const auto* p = dynamic_cast<const ast::Compound*>(node)) {
+                WriteTag(NodeTag::Compound);
+                WriteNodes(p->GetStatements());
+            }
+            else if (const auto* p = dynamic_cast<const ast::MethodBody*>(node)) {
+                WriteTag(NodeTag::MethodBody);
+                WriteNode(&p->GetBody());
+            }
+            else if (const auto* p = dynamic_cast<const ast::Return*>(node)) {
+                WriteTag(NodeTag::Return);
+                WriteNode(&p->GetStatement());
+            }
+            else if (const auto* p = dynamic_cast<const ast::ClassDefinition*>(node)) {
+                WriteTag(NodeTag::ClassDefinition);
+                WriteClass(*p->GetClass().TryAs<runtime::Class>());
+            }
+            else if (const auto* p = dynamic_cast<const ast::IfElse*>(node)) {
+                WriteTag(NodeTag::IfElse);
+                WriteNode(&p->GetCondition());
+                WriteNode(&p->GetIfBody());
+                WriteNode(p->GetElseBody());
+            }
+            else {
+                throw CacheError("Can't serialize node of type "s + typeid(*node).name());
+            }
+        }
+
+    private:
+        void WriteTag(NodeTag tag) {
+            out_ += static_cast<char>(tag);
+        }
+
+        void WriteInt(uint32_t value) {
+            char bytes[sizeof(value)];
+            memcpy(bytes, &value, sizeof(value));
+            out_.append(bytes, sizeof(bytes));
+        }
+
+        void WriteSize(size_t value) {
+            if (value >= NO_INDEX) {
+                throw CacheError("Program is too large to serialize"s);
+            }
+            WriteInt(static_cast<uint32_t>(value));
+        }
+
+        void WriteSlot(size_t slot) {
+            WriteInt(slot == ast::NO_SLOT ? NO_INDEX : static_cast<uint32_t>(slot));
+        }
+
+        void WriteString(string_view str) {
+            WriteSize(str.size());
+            out_ += str;
+        }
+
+        //   ,       .
+        //        
+        void WriteSymbol(runtime::Symbol symbol) {
+            const auto [it, inserted] = symbol_indices_.emplace(symbol, static_cast<uint32_t>(symbol_indices_.size()));
+            WriteInt(it->second);
+            if (inserted) {
+                WriteString(symbol.GetName());
+            }
+        }
+
+        void WriteNodes(const vector<unique_ptr<ast::Statement>>& nodes) {
+            WriteSize(nodes.size());
+            for (const auto& node : nodes) {
+                WriteNode(node.get());
+            }
+        }
+
+        void WriteVariable(const ast::VariableValue& node) {
+            WriteSize(node.GetIds().size());
+            for (const runtime::Symbol id : node.GetIds()) {
+                WriteSymbol(id);
+            }
+            WriteSlot(node.GetSlot());
+        }
+
+        void WriteUnary(NodeTag tag, const ast::UnaryOperation& node) {
+            WriteTag(tag);
+            WriteNode(&node.GetArgument());
+        }
+
+        void WriteBinary(NodeTag tag, const ast::BinaryOperation& node) {
+            WriteTag(tag);
+            WriteNode(&node.GetLhs());
+            WriteNode(&node.GetRhs());
+        }
+
+        //      ,       
+        void WriteClass(const runtime::Class& cls) {
+            const size_t index = class_indices_.size();
+            class_indices_.emplace(&cls, static_cast<uint32_t>(index));
+            WriteString(cls.GetName());
+            WriteInt(cls.GetParent() != nullptr ? ClassIndex(cls.GetParent()) : NO_INDEX);
+
+            const auto& methods = cls.GetOwnMethods();
+            WriteSize(methods.size());
+            for (const runtime::Method& method : methods) {
+                WriteSymbol(method.name);
+                WriteSize(method.formal_params.size());
+                for (const runtime::Symbol param : method.formal_params) {
+                    WriteSymbol(param);
+                }
+                WriteSize(method.frame_size);
+                WriteNode(method.body.get());
+            }
+        }
+
+        uint32_t ClassIndex(const runtime::Class* cls) const {
+            auto it = class_indices_.find(cls);
+            if (it == class_indices_.end()) {
+                throw CacheError("Class "s + cls->GetName() + " is used before its definition"s);
+            }
+            return it->second;
+        }
+
+        string out_;
+        unordered_map<runtime::Symbol, uint32_t> symbol_indices_;
+        unordered_map<const runtime::Class*, uint32_t> class_indices_;
+    };
+
+    //   .      , 
+    //     CacheError,     
+    class Reader {
+    public:
+        explicit Reader(string_view data)
+            : data_(data) {
+        }
+
+        void ReadHeader() {
+            if (ReadBytes(MAGIC.size()) != MAGIC) {
+                throw CacheError("Not a compiled Mython program"s);
+            }
+            if (ReadString() != INTERPRETER_VERSION) {
+                throw CacheError("Compiled program has a different interpreter version"s);
+            }
+        }
+
+        unique_ptr<runtime::Executable> ReadProgram() {
+            auto result = ReadNode();
+            if (pos_ != data_.size()) {
+                throw CacheError("Unexpected data after the program"s);
+            }
+            //      ,  __init__  
+            for (const auto& [node, index] : instances_) {
+                if (classes_[index] == nullptr) {
+                    throw CacheError("Invalid class index"s);
+                }
+                node->Bind(*classes_[index]);
+            }
+            return result;
+        }
+
+    private:
+        unique_ptr<runtime::Executable> ReadNode() {
+            const auto tag = static_cast<NodeTag>(ReadByte());
+            switch (tag) {
+            case NodeTag::Null:
+                return nullptr;
+            case NodeTag::NumericConst:
+                return make_unique<ast::NumericConst>(static_cast<int>(ReadInt()));
+            case NodeTag::StringConst:
+                return make_unique<ast::StringConst>(string(ReadString()));
+            case NodeTag::BoolConst:
+                return make_unique<ast::BoolConst>(runtime::Bool(ReadByte() != 0));
+            case NodeTag::None:
+                return make_unique<ast::None>();
+            case NodeTag::VariableValue:
+                return make_unique<ast::VariableValue>(ReadVariable());
+            case NodeTag::Assignment: {
+                const runtime::Symbol var = ReadSymbol();
+                const size_t slot = ReadSlot();
+                return make_unique<ast::Assignment>(var, slot, ReadRequiredNode());
+            }
+            case NodeTag::FieldAssignment: {
+                ast::VariableValue object = ReadVariable();
+                const runtime::Symbol field_name = ReadSymbol();
+                return make_unique<ast::FieldAssignment>(std::move(object), field_name, ReadRequiredNode());
+            }
+            case NodeTag::Print:
+                return make_unique<ast::Print>(ReadNodes());
+            case NodeTag::MethodCall: {
+                auto object = ReadRequiredNode();
+                const runtime::Symbol method = ReadSymbol();
+                return make_unique<ast::MethodCall>(std::move(object), method, ReadNodes());
+            }
+            case NodeTag::NewInstance: {
+                const uint32_t index = ReadInt();
+                if (index >= classes_.size()) {
+                    throw CacheError("Invalid class index"s);
+                }
+                auto result = make_unique<ast::NewInstance>(ReadNodes());
+                instances_.emplace_back(result.get(), index);
+                return result;
+            }
+            case NodeTag::Stringify:
+                return make_unique<ast::Stringify>(ReadRequiredNode());
+            case NodeTag::Not:
+                return make_unique<ast::Not>(ReadRequiredNode());
+            case NodeTag::Add:
+                return ReadBinary<ast::Add>();
+            case NodeTag::Sub:
+                return ReadBinary<ast::Sub>();
+            case NodeTag::Mult:
+                return ReadBinary<ast::Mult>();
+            case NodeTag::Div:
+                return ReadBinary<ast::Div>();
+            case NodeTag::Or:
+                return ReadBinary<ast::Or>();
+            case NodeTag::And:
+                return ReadBinary<ast::And>();
+            case NodeTag::Comparison: {
+                const uint8_t op = ReadByte();
+                if (op >= COMPARE_OP_COUNT) {
+                    throw CacheError("Invalid comparison operator"s);
+                }
+                auto lhs = ReadRequiredNode();
+                return ast::MakeComparison(static_cast<runtime::CompareOp>(op), std::move(lhs), ReadRequiredNode());
+            }
+            case NodeTag::Compound: {
+                auto result = make_unique<ast::Compound>();
+                for (auto& statement : ReadNodes()) {
+                    result->AddStatement(std::move(statement));
+                }
+                return result;
+            }
+            case NodeTag::MethodBody:
+                return make_unique<ast::MethodBody>(ReadRequiredNode());
+            case NodeTag::Return:
+                return make_unique<ast::Return>(ReadRequiredNode());
+            case NodeTag::ClassDefinition:
+                return make_unique<ast::ClassDefinition>(ReadClass());
+            case NodeTag::IfElse: {
+                auto condition = ReadRequiredNode();
+                auto if_body = ReadRequiredNode();
+                return make_unique<ast::IfElse>(std::move(condition), std::move(if_body), ReadNode());
+            }
+            }
+            throw CacheError("Invalid node tag"s);
+        }
+
+        unique_ptr<runtime::Executable> ReadRequiredNode() {
+            auto result = ReadNode();
+            if (result == nullptr) {
+                throw CacheError("Missing node"s);
+            }
+            return result;
+        }
+
+        vector<unique_ptr<ast::Statement>> ReadNodes() {
+            vector<unique_ptr<ast::Statement>> result(ReadCount());
+            for (auto& node : result) {
+                node = ReadRequiredNode();
+            }
+            return result;
+        }
+
+        template <typename Node>
+        unique_ptr<runtime::Executable> ReadBinary() {
+            auto lhs = ReadRequiredNode();
+            return make_unique<Node>(std::move(lhs), ReadRequiredNode());
+        }
+
+        ast::VariableValue ReadVariable() {
+            vector<runtime::Symbol> ids(ReadCount());
+            if (ids.empty()) {
+                throw CacheError("Empty variable name"s);
+            }
+            for (runtime::Symbol& id : ids) {
+                id = ReadSymbol();
+            }
+            return ast::VariableValue(std::move(ids), ReadSlot());
+        }
+
+        runtime::ObjectHolder ReadClass() {
+            //     ,    
+            const uint32_t index = static_cast<uint32_t>(classes_.size());
+            classes_.push_back(nullptr);
+            string name(ReadString());
+            const uint32_t parent_index = ReadInt();
+            if (parent_index != NO_INDEX && (parent_index >= index || classes_[parent_index] == nullptr)) {
+                throw CacheError("Invalid parent class index"s);
+            }
+
+            vector<runtime::Method> methods(ReadCount());
+            for (runtime::Method& method : methods) {
+                method.name = ReadSymbol();
+                method.formal_params.resize(ReadCount());
+                for (runtime::Symbol& param : method.formal_params) {
+                    param = ReadSymbol();
+                }
+                method.frame_size = ReadInt();
+                method.body = ReadRequiredNode();
+            }
+
+            const runtime::Class* parent = parent_index != NO_INDEX ? classes_[parent_index] : nullptr;
+            auto cls = runtime::ObjectHolder::Own(runtime::Class(std::move(name), std::move(methods), parent));
+            classes_[index] = cls.TryAs<runtime::Class>();
+            return cls;
+        }
+
+        uint8_t ReadByte() {
+            return static_cast<uint8_t>(ReadBytes(1)[0]);
+        }
+
+        uint32_t ReadInt() {
+            uint32_t value = 0;
+            memcpy(&value, ReadBytes(sizeof(value)).data(), sizeof(value));
+            return value;
+        }
+
+        //   .      ,  
+        //      
+        size_t ReadCount() {
+            const size_t count = ReadInt();
+            if (count > data_.size() - pos_) {
+                throw CacheError("Invalid element count"s);
+            }
+            return count;
+        }
+
+        size_t ReadSlot() {
+            const uint32_t slot = ReadInt();
+            return slot == NO_INDEX ? ast::NO_SLOT : slot;
+        }
+
+        string_view ReadString() {
+            return ReadBytes(ReadInt());
+        }
+
+        runtime::Symbol ReadSymbol() {
+            const uint32_t index = ReadInt();
+            if (index < symbols_.size()) {
+                return symbols_[index];
+            }
+            if (index != symbols_.size()) {
+                throw CacheError("Invalid symbol index"s);
+            }
+            return symbols_.emplace_back(ReadString());
+        }
+
+        string_view ReadBytes(size_t size) {
+            if (size > data_.size() - pos_) {
+                throw CacheError("Compiled program is truncated"s);
+            }
+            const string_view result = data_.substr(pos_, size);
+            pos_ += size;
+            return result;
+        }
+
+        string_view data_;
+        size_t pos_ = 0;
+        vector<runtime::Symbol> symbols_;
+        //   .    ,    nullptr
+        vector<const runtime::Class*> classes_;
+        vector<pair<ast::NewInstance*, uint32_t>> instances_;
+    };
+
+    string Serialize(const runtime::Executable& program) {
+        Writer writer;
+        writer.WriteHeader();
+        writer.WriteNode(&program);
+        return writer.Finish();
+    }
+
+    unique_ptr<runtime::Executable> Deserialize(string_view data) {
+        Reader reader(data);
+        reader.ReadHeader();
+        return reader.ReadProgram();
+    }
+
+    uint64_t HashSource(string_view source) {
+        return Fnv1a(source, Fnv1a(INTERPRETER_VERSION));
+    }
+
+    namespace {
+
+        //          ,   
+        //     Serialize.     , 
+        //      
+        struct EntryHeader {
+            uint64_t source_size;
+            uint64_t source_hash;
+        };
+
+        EntryHeader MakeEntryHeader(string_view source) {
+            return { source.size(), HashSource(source) };
+        }
+
+    }  // namespace
+
+    ProgramCache::ProgramCache(string directory)
+        : directory_(std::move(directory)) {
+    }
+
+    string ProgramCache::GetPath(string_view source) const {
+        static const char DIGITS[] = "0123456789abcdef";
+        string name(16, '0');
+        uint64_t hash = HashSource(source);
+        for (size_t i = name.size(); i-- > 0; hash >>= 4) {
+            name[i] = DIGITS[hash & 0xF];
+        }
+        return (filesystem::path(directory_) / (name + ".myc"s)).string();
+    }
+
+    unique_ptr<runtime::Executable> ProgramCache::Load(string_view source) const {
+        const string path = GetPath(source);
+        error_code error;
+        if (!filesystem::is_regular_file(path, error)) {
+            return nullptr;
+        }
+        try {
+            //          
+            const parse::SourceFile file(path);
+            const string_view data = file.GetText();
+            const EntryHeader expected = MakeEntryHeader(source);
+            EntryHeader header{};
+            if (data.size() < sizeof(header)) {
+                return nullptr;
+            }
+            memcpy(&header, data.data(), sizeof(header));
+            if (header.source_size != expected.source_size || header.source_hash != expected.source_hash
+                || data.size() - sizeof(header) < source.size()
+                || data.substr(sizeof(header), source.size()) != source) {
+                return nullptr;
+            }
+            return Deserialize(data.substr(sizeof(header) + source.size()));
+        }
+        catch (const runtime_error&) {
+            return nullptr;
+        }
+    }
+
+    bool ProgramCache::Store(string_view source, const runtime::Executable& program) const {
+        string data;
+        try {
+            data = Serialize(program);
+        }
+        catch (const CacheError&) {
+            return false;
+        }
+
+        error_code error;
+        filesystem::create_directories(directory_, error);
+        const string path = GetPath(source);
+        //       ,     
+        const string temp_path = path + ".tmp"s + to_string(random_device{}());
+        {
+            ofstream output(temp_path, ios::binary | ios::trunc);
+            const EntryHeader header = MakeEntryHeader(source);
+            output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            output.write(source.data(), static_cast<streamsize>(source.size()));
+            output.write(data.data(), static_cast<streamsize>(data.size()));
+            if (!output) {
+                filesystem::remove(temp_path, error);
+                return false;
+            }
+        }
+        filesystem::rename(temp_path, path, error);
+        if (error) {
+            filesystem::remove(temp_path, error);
+            return false;
+        }
+        return true;
+    }
+
+}  // namespace cache
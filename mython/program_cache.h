@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace runtime {
+    class Executable;
+}
+
+namespace cache {
+
+    //      . Ÿ     
+    //      ,     
+    inline constexpr std::string_view INTERPRETER_VERSION = "mython-ast-4";
+
+    class CacheError : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /*
+     *   ,   ParseProgram,      
+     *      .      .
+     *    ,   ,  CacheError
+     */
+    std::string Serialize(const runtime::Executable& program);
+
+    //     ,  Serialize.
+    //        ,  CacheError
+    std::unique_ptr<runtime::Executable> Deserialize(std::string_view data);
+
+    //  64-  FNV-1a     
+    std::uint64_t HashSource(std::string_view source);
+
+    /*
+     *    .     ,  
+     *        ,      .
+     *      ,       ,
+     *    
+     */
+    class ProgramCache {
+    public:
+        //  directory    
+        explicit ProgramCache(std::string directory);
+
+        //         source
+        [[nodiscard]] std::string GetPath(std::string_view source) const;
+
+        //     source  nullptr,      
+        [[nodiscard]] std::unique_ptr<runtime::Executable> Load(std::string_view source) const;
+
+        //     source.    , 
+        //        .
+        //  false,     
+        bool Store(std::string_view source, const runtime::Executable& program) const;
+
+    private:
+        std::string directory_;
+    };
+
+}  // namespace cache
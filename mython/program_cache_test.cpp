@@ -0,0 +1,181 @@
+#include "bytecode.h"
+#include "lexer.h"
+#include "parse.h"
+#include "program_cache.h"
+#include "statement.h"
+#include "test_runner_p.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+using namespace std;
+
+namespace cache {
+
+    namespace {
+
+        const string PROGRAM = R"(
+class Shape:
+  def __init__(name):
+    self.name = name
+
+  def __str__():
+    return self.name + ' ' + str(self.area())
+
+  def area():
+    return 0
+
+class Rect(Shape):
+  def __init__(w, h):
+    self.name = 'rect'
+    self.w = w
+    self.h = h
+
+  def area():
+    return self.w * self.h
+
+  def grow(n):
+    if n > 0 and not n == 3 or n >= 100:
+      self.w = self.w + 1
+      return self.grow(n - 1)
+    else:
+      return self
+
+class Node:
+  def __init__():
+    self.next = None
+
+class Chain:
+  def link(n):
+    if n <= 0:
+      return None
+    result = Node()
+    result.next = self.link(n - 1)
+    return result
+
+r = Rect(2, 5)
+named = Shape("it's \"quoted\"")
+print r, named, r.w != 3, r.h < 6, r.w > 1, 10 / 3 - 1, True, False
+small = Rect(1, 1)
+head = Chain()
+chain = head.link(2)
+print small.grow(2), chain.next.next
+)"s;
+
+        const string EXPECTED_OUTPUT = "rect 10 it's \"quoted\" 0 True True True 2 True False\nrect 3 None\n"s;
+
+        unique_ptr<runtime::Executable> Parse(const string& program) {
+            istringstream input(program);
+            parse::Lexer lexer(input);
+            return ParseProgram(lexer);
+        }
+
+        string Run(unique_ptr<runtime::Executable> program, bool compile) {
+            if (compile) {
+                program = bytecode::Compile(std::move(program));
+            }
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            program->Execute(closure, context);
+            return context.output.str();
+        }
+
+        //  ,      
+        class TempDirectory {
+        public:
+            TempDirectory()
+                : path_(filesystem::temp_directory_path() / ("mython-cache-test-"s + to_string(random_device{}()))) {
+            }
+
+            ~TempDirectory() {
+                error_code error;
+                filesystem::remove_all(path_, error);
+            }
+
+            [[nodiscard]] string GetPath() const {
+                return path_.string();
+            }
+
+        private:
+            filesystem::path path_;
+        };
+
+        void TestRoundTrip() {
+            const string data = Serialize(*Parse(PROGRAM));
+            ASSERT_EQUAL(Serialize(*Deserialize(data)), data);
+            for (const bool compile : { false, true }) {
+                ASSERT_EQUAL(Run(Deserialize(data), compile), EXPECTED_OUTPUT);
+            }
+        }
+
+        void TestCorruptedData() {
+            const string data = Serialize(*Parse(PROGRAM));
+            //    
+            for (size_t size = 0; size < data.size(); size += 7) {
+                ASSERT_THROWS(Deserialize(string_view(data).substr(0, size)), CacheError);
+            }
+            ASSERT_THROWS(Deserialize(data + "x"s), CacheError);
+
+            string other_version = data;
+            other_version[other_version.find(INTERPRETER_VERSION)] ^= 1;
+            ASSERT_THROWS(Deserialize(other_version), CacheError);
+
+            //      
+            ASSERT_THROWS(Serialize(*bytecode::Compile(Parse(PROGRAM))), CacheError);
+        }
+
+        void TestProgramCache() {
+            const TempDirectory directory;
+            const ProgramCache cache(directory.GetPath());
+            ASSERT(cache.Load(PROGRAM) == nullptr);
+
+            ASSERT(cache.Store(PROGRAM, *Parse(PROGRAM)));
+            ASSERT(filesystem::exists(cache.GetPath(PROGRAM)));
+            ASSERT_EQUAL(Run(cache.Load(PROGRAM), false), EXPECTED_OUTPUT);
+
+            //     ,      
+            const string other = PROGRAM + "print 1\n"s;
+            ASSERT(cache.GetPath(other) != cache.GetPath(PROGRAM));
+            ASSERT(cache.Load(other) == nullptr);
+
+            //         ,   ,  
+            {
+                string same_size = PROGRAM;
+                same_size[same_size.find("Rect(2, 5)"s) + 5] = '3';
+                ASSERT(cache.Store(same_size, *Parse(same_size)));
+                string entry;
+                {
+                    ifstream input(cache.GetPath(same_size), ios::binary);
+                    entry.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+                }
+                //  :  ,   
+                const uint64_t hash = HashSource(PROGRAM);
+                entry.replace(sizeof(uint64_t), sizeof(hash), reinterpret_cast<const char*>(&hash), sizeof(hash));
+                ofstream output(cache.GetPath(PROGRAM), ios::binary | ios::trunc);
+                output << entry;
+            }
+            ASSERT(cache.Load(PROGRAM) == nullptr);
+            ASSERT(cache.Store(PROGRAM, *Parse(PROGRAM)));
+            ASSERT_EQUAL(Run(cache.Load(PROGRAM), false), EXPECTED_OUTPUT);
+
+            //    
+            {
+                ofstream output(cache.GetPath(PROGRAM), ios::binary | ios::app);
+                output << "garbage"s;
+            }
+            ASSERT(cache.Load(PROGRAM) == nullptr);
+            ASSERT(cache.Store(PROGRAM, *Parse(PROGRAM)));
+            ASSERT(cache.Load(PROGRAM) != nullptr);
+        }
+
+    }  // namespace
+
+    void RunProgramCacheTests(TestRunner& tr) {
+        RUN_TEST(tr, cache::TestRoundTrip);
+        RUN_TEST(tr, cache::TestCorruptedData);
+        RUN_TEST(tr, cache::TestProgramCache);
+    }
+
+}  // namespace cache
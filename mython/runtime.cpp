@@ -1,5 +1,6 @@
 #include "runtime.h"
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
 #include <sstream>
@@ -8,17 +9,68 @@ using namespace std;
 
 namespace runtime {
 
+    namespace {
+        const Symbol ADD_METHOD{ "__add__"sv };
+        const Symbol EQ_METHOD{ "__eq__"sv };
+        const Symbol LT_METHOD{ "__lt__"sv };
+        const Symbol NE_METHOD{ "__ne__"sv };
+        const Symbol GT_METHOD{ "__gt__"sv };
+        const Symbol LE_METHOD{ "__le__"sv };
+        const Symbol GE_METHOD{ "__ge__"sv };
+        const Symbol STR_METHOD{ "__str__"sv };
+        const Symbol SELF{ "self"sv };
+
+        bool HasKind(const Object* object, ObjectKind kind) {
+            return object != nullptr && object->GetKind() == kind;
+        }
+
+        bool AreNumbers(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return HasKind(lhs.Get(), ObjectKind::Number) && HasKind(rhs.Get(), ObjectKind::Number);
+        }
+
+        //   ,    
+        template <typename T>
+        const auto& ValueOf(const Object* object) {
+            return static_cast<const T*>(object)->GetValue();
+        }
+
+        //    ,   
+        constexpr size_t INLINE_FRAME_SIZE = 8;
+
+        //       
+        class FrameGuard {
+        public:
+            FrameGuard(Context& context, LocalSlot* frame)
+                : context_(context)
+                , previous_(context.SwapFrame(frame)) {
+            }
+
+            FrameGuard(const FrameGuard&) = delete;
+            FrameGuard& operator=(const FrameGuard&) = delete;
+
+            ~FrameGuard() {
+                context_.SwapFrame(previous_);
+            }
+
+        private:
+            Context& context_;
+            LocalSlot* previous_;
+        };
+    }  // namespace
+
     ObjectHolder::ObjectHolder(std::shared_ptr<Object> data)
         : data_(std::move(data)) {
     }
 
     void ObjectHolder::AssertIsValid() const {
-        assert(data_ != nullptr);
+        assert(Get() != nullptr);
     }
 
     ObjectHolder ObjectHolder::Share(Object& object) {
-        //   shared_ptr ( deleter   )
-        return ObjectHolder(std::shared_ptr<Object>(&object, [](auto* /*p*/) { /* do nothing */ }));
+        //      ,    
+        ObjectHolder result;
+        result.data_.emplace<Object*>(&object);
+        return result;
     }
 
     ObjectHolder ObjectHolder::None() {
@@ -36,7 +88,19 @@ namespace runtime {
     }
 
     Object* ObjectHolder::Get() const {
-        return data_.get();
+        if (auto* object = std::get_if<std::shared_ptr<Object>>(&data_)) {
+            return object->get();
+        }
+        if (auto* borrowed = std::get_if<Object*>(&data_)) {
+            return *borrowed;
+        }
+        if (auto* number = std::get_if<Number>(&data_)) {
+            return number;
+        }
+        if (auto* boolean = std::get_if<Bool>(&data_)) {
+            return boolean;
+        }
+        return nullptr;
     }
 
     ObjectHolder::operator bool() const {
@@ -44,22 +108,38 @@ namespace runtime {
     }
 
     bool IsTrue(const ObjectHolder& object) {
-        if (object.TryAs<Number>()) {
-            return (object.TryAs<Number>()->GetValue() != 0);
+        const Object* obj = object.Get();
+        if (obj == nullptr) {
+            return false;
         }
-        if (object.TryAs<Bool>()) {
-            return object.TryAs<Bool>()->GetValue();
-        }
-        if (object.TryAs<String>()) {
-            return !object.TryAs<String>()->GetValue().empty();
+        switch (obj->GetKind()) {
+        case ObjectKind::Number:
+            return ValueOf<Number>(obj) != 0;
+        case ObjectKind::Bool:
+            return ValueOf<Bool>(obj);
+        case ObjectKind::String:
+            return !ValueOf<String>(obj).empty();
+        default:
+            return false;
         }
+    }
 
+    bool Executable::EvaluateBool(Closure& closure, Context& context) {
+        return IsTrue(Execute(closure, context));
+    }
+
+    bool Executable::EvaluateInt(Closure& closure, Context& context, int& number, ObjectHolder& value) {
+        value = Execute(closure, context);
+        if (const auto* result = value.TryAs<Number>()) {
+            number = result->GetValue();
+            return true;
+        }
         return false;
     }
 
     void ClassInstance::Print(std::ostream& os, Context& context) {
-        if (HasMethod("__str__"s, 0)) {
-            auto res = Call("__str__"s, {}, context);
+        if (const Method* str_method = cls_.GetMethod(STR_METHOD, 0)) {
+            auto res = Call(*str_method, {}, context);
             res->Print(os, context);
         }
         else {
@@ -67,65 +147,301 @@ namespace runtime {
         }
     }
 
-    bool ClassInstance::HasMethod(const std::string& method, size_t argument_count) const {
-        auto temp_method = cls_.GetMethod(method);
-        if (temp_method != nullptr) {
-            return (temp_method->formal_params.size() == argument_count);
-        }
-        return false;
+    bool ClassInstance::HasMethod(Symbol method, size_t argument_count) const {
+        return cls_.GetMethod(method, argument_count) != nullptr;
     }
 
-    Closure& ClassInstance::Fields() {
+    InstanceFields& ClassInstance::Fields() {
         return fields_;
     }
 
-    const Closure& ClassInstance::Fields() const {
+    const InstanceFields& ClassInstance::Fields() const {
         return fields_;
     }
 
+    const Class& ClassInstance::GetClass() const {
+        return cls_;
+    }
+
+    const Method* MethodCache::Lookup(const Class& cls, Symbol name, size_t argument_count) {
+        for (size_t i = 0; i < size_; ++i) {
+            if (entries_[i].cls == &cls) {
+                ++stats_.hits;
+                ++TotalStats().hits;
+                return entries_[i].method;
+            }
+        }
+        ++stats_.misses;
+        ++TotalStats().misses;
+        const Method* method = cls.GetMethod(name, argument_count);
+        if (size_ < CAPACITY) {
+            entries_[size_++] = { &cls, method };
+        }
+        return method;
+    }
+
+    const MethodCache::Stats& MethodCache::GetStats() const {
+        return stats_;
+    }
+
+    size_t MethodCache::GetSize() const {
+        return size_;
+    }
+
+    MethodCache::Stats& MethodCache::TotalStats() {
+        //     ,      
+        thread_local Stats total;
+        return total;
+    }
+
+    ObjectHolder ClassInstance::MakeSelf() {
+        if (std::shared_ptr<ClassInstance> owner = weak_from_this().lock()) {
+            return ObjectHolder(std::move(owner));
+        }
+        return ObjectHolder::Share(*this);
+    }
+
+    ObjectHolder ClassInstance::CallWithFrame(const Method& method, Executable& body, const ObjectHolder* actual_args,
+        size_t arg_count, Context& context) {
+        //      
+        LocalSlot inline_frame[INLINE_FRAME_SIZE];
+        std::vector<LocalSlot> heap_frame;
+        LocalSlot* frame = inline_frame;
+        if (method.frame_size > INLINE_FRAME_SIZE) {
+            heap_frame.resize(method.frame_size);
+            frame = heap_frame.data();
+        }
+        frame[0] = { MakeSelf(), true };
+        for (size_t i = 0; i < arg_count; ++i) {
+            frame[i + 1] = { actual_args[i], true };
+        }
+
+        FrameGuard guard(context, frame);
+        Closure closure;
+        return body.Execute(closure, context);
+    }
+
+    Shape::Shape(const Shape* root, std::vector<Symbol> names)
+        : root_(root)
+        , names_(std::move(names)) {
+        for (size_t i = 0; i < names_.size(); ++i) {
+            indices_.emplace(names_[i], i);
+        }
+    }
+
+    size_t Shape::Find(Symbol name) const {
+        auto it = indices_.find(name);
+        return it != indices_.end() ? it->second : NO_FIELD;
+    }
+
+    const Shape* Shape::Extend(Symbol name) const {
+        auto& next = transitions_[name];
+        if (!next) {
+            std::vector<Symbol> names = names_;
+            names.push_back(name);
+            next.reset(new Shape(root_, std::move(names)));
+            root_->max_field_count_ = std::max(root_->max_field_count_, next->names_.size());
+        }
+        return next.get();
+    }
+
+    size_t Shape::GetFieldCount() const {
+        return names_.size();
+    }
+
+    const std::string& Shape::GetFieldName(size_t index) const {
+        return names_[index].GetName();
+    }
+
+    size_t Shape::GetMaxFieldCount() const {
+        return root_->max_field_count_;
+    }
+
+    InstanceFields::InstanceFields(const Shape* shape)
+        : shape_(shape) {
+        //       ,    
+        values_.reserve(shape->GetMaxFieldCount());
+    }
+
+    ObjectHolder& InstanceFields::operator[](Symbol name) {
+        const size_t index = shape_->Find(name);
+        if (index != Shape::NO_FIELD) {
+            return values_[index];
+        }
+        shape_ = shape_->Extend(name);
+        return values_.emplace_back();
+    }
+
+    ObjectHolder& InstanceFields::at(Symbol name) {
+        const size_t index = shape_->Find(name);
+        if (index == Shape::NO_FIELD) {
+            throw std::out_of_range("No field "s + name.GetName());
+        }
+        return values_[index];
+    }
+
+    const ObjectHolder& InstanceFields::at(Symbol name) const {
+        return const_cast<InstanceFields&>(*this).at(name);
+    }
+
+    InstanceFields::iterator InstanceFields::find(Symbol name) {
+        const size_t index = shape_->Find(name);
+        return index != Shape::NO_FIELD ? iterator(this, index) : end();
+    }
+
+    InstanceFields::const_iterator InstanceFields::find(Symbol name) const {
+        const size_t index = shape_->Find(name);
+        return index != Shape::NO_FIELD ? const_iterator(this, index) : end();
+    }
+
+    size_t InstanceFields::count(Symbol name) const {
+        return shape_->Find(name) != Shape::NO_FIELD ? 1 : 0;
+    }
+
+    InstanceFields::iterator InstanceFields::begin() {
+        return { this, 0 };
+    }
+
+    InstanceFields::iterator InstanceFields::end() {
+        return { this, values_.size() };
+    }
+
+    InstanceFields::const_iterator InstanceFields::begin() const {
+        return { this, 0 };
+    }
+
+    InstanceFields::const_iterator InstanceFields::end() const {
+        return { this, values_.size() };
+    }
+
+    size_t InstanceFields::size() const {
+        return values_.size();
+    }
+
+    const Shape* InstanceFields::GetShape() const {
+        return shape_;
+    }
+
+    ObjectHolder* FieldCache::Find(InstanceFields& fields, Symbol name) {
+        if (fields.shape_ != shape_) {
+            const size_t index = fields.shape_->Find(name);
+            if (index == Shape::NO_FIELD) {
+                return nullptr;
+            }
+            shape_ = fields.shape_;
+            index_ = index;
+        }
+        return &fields.values_[index_];
+    }
+
+    ObjectHolder& FieldCache::Emplace(InstanceFields& fields, Symbol name) {
+        if (fields.shape_ == added_from_) {
+            fields.shape_ = added_to_;
+            return fields.values_.emplace_back();
+        }
+        if (ObjectHolder* field = Find(fields, name)) {
+            return *field;
+        }
+        added_from_ = fields.shape_;
+        added_to_ = fields.shape_->Extend(name);
+        fields.shape_ = added_to_;
+        return fields.values_.emplace_back();
+    }
+
     ClassInstance::ClassInstance(const Class& cls)
-        : cls_(cls) {
+        : Object(ObjectKind::ClassInstance)
+        , cls_(cls)
+        , fields_(cls.GetRootShape()) {
     }
 
-    ObjectHolder ClassInstance::Call(const std::string& method,
+    ObjectHolder ClassInstance::Call(Symbol method,
         const std::vector<ObjectHolder>& actual_args,
         Context& context) {
-        if (!HasMethod(method, actual_args.size())) {
+        const Method* temp_method = cls_.GetMethod(method, actual_args.size());
+        if (temp_method == nullptr) {
             throw std::runtime_error("Cannot call method"s);
         }
-        const Method* temp_method = cls_.GetMethod(method);
+        return Call(*temp_method, actual_args, context);
+    }
+
+    ObjectHolder ClassInstance::Call(const Method& method, const std::vector<ObjectHolder>& actual_args,
+        Context& context) {
+        return Call(method, actual_args.data(), actual_args.size(), context);
+    }
+
+    ObjectHolder ClassInstance::Call(const Method& method, const ObjectHolder* actual_args, size_t arg_count,
+        Context& context) {
+        return Call(method, *method.body, actual_args, arg_count, context);
+    }
+
+    ObjectHolder ClassInstance::Call(const Method& method, Executable& body, const ObjectHolder* actual_args,
+        size_t arg_count, Context& context) {
+        if (method.frame_size != 0) {
+            return CallWithFrame(method, body, actual_args, arg_count, context);
+        }
         Closure closure;
-        closure["self"s] = ObjectHolder::Share(*this);
-        size_t args_counter = 0;
-        for (const auto i : actual_args) {
-            closure[temp_method->formal_params[args_counter]] = i;
-            ++args_counter;
+        closure[SELF] = MakeSelf();
+        for (size_t i = 0; i < arg_count; ++i) {
+            closure[method.formal_params[i]] = actual_args[i];
         }
-        return temp_method->body->Execute(closure, context);
+        return body.Execute(closure, context);
     }
 
     Class::Class(std::string name, std::vector<Method> methods, const Class* parent)
-        : name_(name)
+        : Object(ObjectKind::Class)
+        , name_(name)
         , methods_(std::move(methods))
         , parent_(parent) {
+        BuildMethodTable();
     }
 
-    const Method* Class::GetMethod(const std::string& name) const {
-        for (const auto& i : methods_) {
-            if (i.name == name) {
-                return &i;
-            }
+    void Class::BuildMethodTable() {
+        if (parent_ != nullptr) {
+            method_table_ = parent_->method_table_;
         }
-        if (parent_) {
-            return parent_->GetMethod(name);
+        else {
+            method_table_.clear();
         }
-        return nullptr;
+        //   ,       ,    
+        for (auto it = methods_.rbegin(); it != methods_.rend(); ++it) {
+            method_table_.insert_or_assign(it->name, MethodEntry{ &*it, it->formal_params.size() });
+        }
+    }
+
+    const Method* Class::GetMethod(Symbol name) const {
+        auto it = method_table_.find(name);
+        return it != method_table_.end() ? it->second.method : nullptr;
+    }
+
+    const Method* Class::GetMethod(Symbol name, size_t argument_count) const {
+        auto it = method_table_.find(name);
+        if (it == method_table_.end() || it->second.arity != argument_count) {
+            return nullptr;
+        }
+        return it->second.method;
     }
 
     const std::string& Class::GetName() const {
         return name_;
     }
 
+    const Class* Class::GetParent() const {
+        return parent_;
+    }
+
+    void Class::SetParent(const Class* parent) {
+        parent_ = parent;
+        BuildMethodTable();
+    }
+
+    const Shape* Class::GetRootShape() const {
+        return root_shape_.get();
+    }
+
+    const std::vector<Method>& Class::GetOwnMethods() const {
+        return methods_;
+    }
+
     void Class::Print(ostream& os, [[maybe_unused]] Context& context) {
         os << "Class "s << name_;
     }
@@ -135,57 +451,205 @@ namespace runtime {
     }
 
     bool Equal(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        if (!lhs && !rhs) {
+        const Object* l = lhs.Get();
+        const Object* r = rhs.Get();
+        if (l == nullptr && r == nullptr) {
             return true;
         }
-        if (lhs.TryAs<Number>() && rhs.TryAs<Number>()) {
-            return lhs.TryAs<Number>()->GetValue() == rhs.TryAs<Number>()->GetValue();
-        }
-        if (lhs.TryAs<String>() && rhs.TryAs<String>()) {
-            return lhs.TryAs<String>()->GetValue() == rhs.TryAs<String>()->GetValue();
-        }
-        if (lhs.TryAs<Bool>() && rhs.TryAs<Bool>()) {
-            return lhs.TryAs<Bool>()->GetValue() == rhs.TryAs<Bool>()->GetValue();
+        if (l == nullptr) {
+            throw std::runtime_error("Cannot compare objects for equality"s);
         }
-        if (lhs.TryAs<ClassInstance>()) {
-            if (lhs.TryAs<ClassInstance>()->HasMethod("__eq__"s, 1)) {
-                return (bool)lhs.TryAs<ClassInstance>()->Call("__eq__"s, { rhs }, context).TryAs<Bool>()->GetValue();
+        switch (l->GetKind()) {
+        case ObjectKind::Number:
+            if (HasKind(r, ObjectKind::Number)) {
+                return ValueOf<Number>(l) == ValueOf<Number>(r);
+            }
+            break;
+        case ObjectKind::String:
+            if (HasKind(r, ObjectKind::String)) {
+                return ValueOf<String>(l) == ValueOf<String>(r);
+            }
+            break;
+        case ObjectKind::Bool:
+            if (HasKind(r, ObjectKind::Bool)) {
+                return ValueOf<Bool>(l) == ValueOf<Bool>(r);
+            }
+            break;
+        case ObjectKind::ClassInstance: {
+            auto* instance = lhs.TryAs<ClassInstance>();
+            if (const Method* method = instance->GetClass().GetMethod(EQ_METHOD, 1)) {
+                return IsTrue(instance->Call(*method, { rhs }, context));
             }
+            break;
+        }
+        default:
+            break;
         }
         throw std::runtime_error("Cannot compare objects for equality"s);
     }
 
     bool Less(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        if (lhs.TryAs<Number>() && rhs.TryAs<Number>()) {
-            return lhs.TryAs<Number>()->GetValue() < rhs.TryAs<Number>()->GetValue();
+        const Object* l = lhs.Get();
+        const Object* r = rhs.Get();
+        if (l == nullptr) {
+            throw std::runtime_error("Cannot compare objects for less"s);
         }
-        if (lhs.TryAs<String>() && rhs.TryAs<String>()) {
-            return lhs.TryAs<String>()->GetValue() < rhs.TryAs<String>()->GetValue();
+        switch (l->GetKind()) {
+        case ObjectKind::Number:
+            if (HasKind(r, ObjectKind::Number)) {
+                return ValueOf<Number>(l) < ValueOf<Number>(r);
+            }
+            break;
+        case ObjectKind::String:
+            if (HasKind(r, ObjectKind::String)) {
+                return ValueOf<String>(l) < ValueOf<String>(r);
+            }
+            break;
+        case ObjectKind::Bool:
+            if (HasKind(r, ObjectKind::Bool)) {
+                return ValueOf<Bool>(l) < ValueOf<Bool>(r);
+            }
+            break;
+        case ObjectKind::ClassInstance: {
+            auto* instance = lhs.TryAs<ClassInstance>();
+            if (const Method* method = instance->GetClass().GetMethod(LT_METHOD, 1)) {
+                return IsTrue(instance->Call(*method, { rhs }, context));
+            }
+            break;
         }
-        if (lhs.TryAs<Bool>() && rhs.TryAs<Bool>()) {
-            return lhs.TryAs<Bool>()->GetValue() < rhs.TryAs<Bool>()->GetValue();
+        default:
+            break;
         }
-        if (lhs.TryAs<ClassInstance>()) {
-            if (lhs.TryAs<ClassInstance>()->HasMethod("__lt__"s, 1)) {
-                return lhs.TryAs<ClassInstance>()->Call("__lt__"s, { rhs }, context).TryAs<Bool>()->GetValue();
+        throw std::runtime_error("Cannot compare objects for less"s);
+    }
+
+    ObjectHolder Add(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        const Object* l = lhs.Get();
+        const Object* r = rhs.Get();
+        if (l != nullptr) {
+            switch (l->GetKind()) {
+            case ObjectKind::Number:
+                if (HasKind(r, ObjectKind::Number)) {
+                    return ObjectHolder::Own(Number(ValueOf<Number>(l) + ValueOf<Number>(r)));
+                }
+                break;
+            case ObjectKind::String:
+                if (HasKind(r, ObjectKind::String)) {
+                    return ObjectHolder::Own(String(ValueOf<String>(l) + ValueOf<String>(r)));
+                }
+                break;
+            case ObjectKind::ClassInstance: {
+                auto* instance = lhs.TryAs<ClassInstance>();
+                if (const Method* method = instance->GetClass().GetMethod(ADD_METHOD, 1)) {
+                    return instance->Call(*method, { rhs }, context);
+                }
+                break;
+            }
+            default:
+                break;
             }
         }
-        throw std::runtime_error("Cannot compare objects for less"s);
+        throw std::runtime_error("Addition error"s);
+    }
+
+    ObjectHolder Sub(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+        if (AreNumbers(lhs, rhs)) {
+            return ObjectHolder::Own(Number(ValueOf<Number>(lhs.Get()) - ValueOf<Number>(rhs.Get())));
+        }
+        throw std::runtime_error("Substraction error"s);
+    }
+
+    ObjectHolder Mult(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+        if (AreNumbers(lhs, rhs)) {
+            return ObjectHolder::Own(Number(ValueOf<Number>(lhs.Get()) * ValueOf<Number>(rhs.Get())));
+        }
+        throw std::runtime_error("Multiplication error"s);
+    }
+
+    ObjectHolder Div(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+        if (AreNumbers(lhs, rhs)) {
+            const int divisor = ValueOf<Number>(rhs.Get());
+            if (divisor != 0) {
+                return ObjectHolder::Own(Number(ValueOf<Number>(lhs.Get()) / divisor));
+            }
+            else {
+                throw std::runtime_error("Error. Division by zero"s);
+            }
+        }
+        throw std::runtime_error("Division error"s);
+    }
+
+    namespace {
+        //    name  object   arg.
+        //  nullopt,  object -      
+        optional<bool> CallComparison(const ObjectHolder& object, Symbol name, const ObjectHolder& arg,
+            Context& context) {
+            if (auto* instance = object.TryAs<ClassInstance>()) {
+                if (const Method* method = instance->GetClass().GetMethod(name, 1)) {
+                    return IsTrue(instance->Call(*method, { arg }, context));
+                }
+            }
+            return nullopt;
+        }
+    }  // namespace
+
+    ComparisonMethod FindComparisonMethod(const Class& cls, CompareOp op) {
+        //          
+        switch (op) {
+        case CompareOp::Equal:
+            return { cls.GetMethod(EQ_METHOD, 1), false };
+        case CompareOp::NotEqual:
+            if (const Method* method = cls.GetMethod(NE_METHOD, 1)) {
+                return { method, false };
+            }
+            return { cls.GetMethod(EQ_METHOD, 1), true };
+        case CompareOp::Less:
+            return { cls.GetMethod(LT_METHOD, 1), false };
+        case CompareOp::Greater:
+            return { cls.GetMethod(GT_METHOD, 1), false };
+        case CompareOp::LessOrEqual:
+            if (const Method* method = cls.GetMethod(LE_METHOD, 1)) {
+                return { method, false };
+            }
+            return { cls.GetMethod(GT_METHOD, 1), true };
+        case CompareOp::GreaterOrEqual:
+            if (const Method* method = cls.GetMethod(GE_METHOD, 1)) {
+                return { method, false };
+            }
+            return { cls.GetMethod(LT_METHOD, 1), true };
+        }
+        return {};
     }
 
     bool NotEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        if (const auto result = CallComparison(lhs, NE_METHOD, rhs, context)) {
+            return *result;
+        }
         return !Equal(lhs, rhs, context);
     }
 
     bool Greater(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        if (const auto result = CallComparison(lhs, GT_METHOD, rhs, context)) {
+            return *result;
+        }
+        //   Python, lhs > rhs  rhs < lhs
+        if (const auto result = CallComparison(rhs, LT_METHOD, lhs, context)) {
+            return *result;
+        }
         return (!Less(lhs, rhs, context) && NotEqual(lhs, rhs, context));
     }
 
     bool LessOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        if (const auto result = CallComparison(lhs, LE_METHOD, rhs, context)) {
+            return *result;
+        }
         return !Greater(lhs, rhs, context);
     }
 
     bool GreaterOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        if (const auto result = CallComparison(lhs, GE_METHOD, rhs, context)) {
+            return *result;
+        }
         return !Less(lhs, rhs, context);
     }
 
@@ -1,29 +1,150 @@
 #pragma once
 
+#include "pool_allocator.h"
+#include "symbol.h"
+
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace runtime {
 
+    struct LocalSlot;
+
     //    Mython
     class Context {
     public:
         //      print
         virtual std::ostream& GetOutputStream() = 0;
 
+        // ,    return.   , Compound  IfElse
+        //    ,  MethodBody     
+        void SetReturning(bool returning) {
+            returning_ = returning;
+        }
+
+        [[nodiscard]] bool IsReturning() const {
+            return returning_;
+        }
+
+        //      nullptr,     
+        [[nodiscard]] LocalSlot* GetFrame() const {
+            return frame_;
+        }
+
+        //  frame     
+        LocalSlot* SwapFrame(LocalSlot* frame) {
+            LocalSlot* previous = frame_;
+            frame_ = frame;
+            return previous;
+        }
+
     protected:
         ~Context() = default;
+
+    private:
+        bool returning_ = false;
+        LocalSlot* frame_ = nullptr;
+    };
+
+    //  .       dynamic_cast
+    enum class ObjectKind : std::uint8_t {
+        Number,
+        String,
+        Bool,
+        Class,
+        ClassInstance,
+        //   Object,     dynamic_cast
+        Other,
     };
 
     //       Mython
     class Object {
     public:
+        Object() = default;
         virtual ~Object() = default;
         //   os     
         virtual void Print(std::ostream& os, Context& context) = 0;
+
+        [[nodiscard]] ObjectKind GetKind() const {
+            return kind_;
+        }
+
+    protected:
+        explicit Object(ObjectKind kind)
+            : kind_(kind) {
+        }
+
+    private:
+        ObjectKind kind_ = ObjectKind::Other;
+    };
+
+    template <typename T>
+    class ValueObject;
+    class Bool;
+    class Class;
+    class ClassInstance;
+
+    // ,      T.  ObjectKind::Other    dynamic_cast
+    template <typename T>
+    inline constexpr ObjectKind OBJECT_KIND = ObjectKind::Other;
+    template <>
+    inline constexpr ObjectKind OBJECT_KIND<ValueObject<int>> = ObjectKind::Number;
+    template <>
+    inline constexpr ObjectKind OBJECT_KIND<ValueObject<std::string>> = ObjectKind::String;
+    template <>
+    inline constexpr ObjectKind OBJECT_KIND<Bool> = ObjectKind::Bool;
+    template <>
+    inline constexpr ObjectKind OBJECT_KIND<Class> = ObjectKind::Class;
+    template <>
+    inline constexpr ObjectKind OBJECT_KIND<ClassInstance> = ObjectKind::ClassInstance;
+
+    // -,    T
+    template <typename T>
+    class ValueObject : public Object {
+    public:
+        ValueObject(T v)  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+            : Object(OBJECT_KIND<ValueObject<T>>)
+            , value_(v) {
+        }
+
+        void Print(std::ostream& os, [[maybe_unused]] Context& context) override {
+            os << value_;
+        }
+
+        [[nodiscard]] const T& GetValue() const {
+            return value_;
+        }
+
+    protected:
+        ValueObject(T v, ObjectKind kind)
+            : Object(kind)
+            , value_(v) {
+        }
+
+    private:
+        T value_;
+    };
+
+    //  
+    using String = ValueObject<std::string>;
+    //  
+    using Number = ValueObject<int>;
+
+    //  
+    class Bool : public ValueObject<bool> {
+    public:
+        Bool(bool v)  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+            : ValueObject<bool>(v, ObjectKind::Bool) {
+        }
+
+        void Print(std::ostream& os, Context& context) override;
     };
 
     //  -,      Mython-
@@ -34,13 +155,22 @@ namespace runtime {
 
         //  ObjectHolder,    T
         //  T -  - Object.
-        // object     
+        //        ObjectHolder,
+        //          PoolAllocator
         template <typename T>
         [[nodiscard]] static ObjectHolder Own(T&& object) {
-            return ObjectHolder(std::make_shared<T>(std::forward<T>(object)));
+            using Type = std::decay_t<T>;
+            if constexpr (std::is_same_v<Type, Number> || std::is_same_v<Type, Bool>) {
+                ObjectHolder result;
+                result.data_.template emplace<Type>(std::forward<T>(object));
+                return result;
+            }
+            else {
+                return ObjectHolder(std::allocate_shared<Type>(PoolAllocator<Type>(), std::forward<T>(object)));
+            }
         }
 
-        //  ObjectHolder,    (  )
+        //  ObjectHolder,    (  ).   
         [[nodiscard]] static ObjectHolder Share(Object& object);
         //   ObjectHolder,   None
         [[nodiscard]] static ObjectHolder None();
@@ -57,41 +187,39 @@ namespace runtime {
         //   
         template <typename T>
         [[nodiscard]] T* TryAs() const {
-            return dynamic_cast<T*>(this->Get());
+            Object* object = this->Get();
+            if constexpr (OBJECT_KIND<T> != ObjectKind::Other) {
+                return object != nullptr && object->GetKind() == OBJECT_KIND<T> ? static_cast<T*>(object) : nullptr;
+            }
+            else {
+                return dynamic_cast<T*>(object);
+            }
         }
 
         //  true,  ObjectHolder  
         explicit operator bool() const;
 
     private:
+        friend class ClassInstance;
+
         explicit ObjectHolder(std::shared_ptr<Object> data);
         void AssertIsValid() const;
 
-        std::shared_ptr<Object> data_;
-    };
-
-    // -,    T
-    template <typename T>
-    class ValueObject : public Object {
-    public:
-        ValueObject(T v)  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
-            : value_(v) {
-        }
-
-        void Print(std::ostream& os, [[maybe_unused]] Context& context) override {
-            os << value_;
-        }
-
-        [[nodiscard]] const T& GetValue() const {
-            return value_;
-        }
-
-    private:
-        T value_;
+        //   (None),   ,    
+        //     ,         
+        mutable std::variant<std::monostate, std::shared_ptr<Object>, Object*, Number, Bool> data_;
     };
 
     //  ,      
-    using Closure = std::unordered_map<std::string, ObjectHolder>;
+    using Closure = std::unordered_map<Symbol, ObjectHolder>;
+
+    //   .        
+    //   :  0  self,    ,   
+    struct LocalSlot {
+        ObjectHolder value;
+        //     . None   
+        bool bound = false;
+    };
 
     // ,    object ,   True
     //     , True     true.    - false.
@@ -104,29 +232,157 @@ namespace runtime {
         //      closure,  context
         //     None
         virtual ObjectHolder Execute(Closure& closure, [[maybe_unused]] Context& context) = 0;
-    };
 
-    //  
-    using String = ValueObject<std::string>;
-    //  
-    using Number = ValueObject<int>;
+        //     ,   Bool,  IsTrue.
+        // ,    ,  ,    ObjectHolder
+        virtual bool EvaluateBool(Closure& closure, Context& context);
 
-    //  
-    class Bool : public ValueObject<bool> {
-    public:
-        using ValueObject<bool>::ValueObject;
-
-        void Print(std::ostream& os, Context& context) override;
+        //  .       ObjectHolder,    number
+        //   true.     value   false
+        virtual bool EvaluateInt(Closure& closure, Context& context, int& number, ObjectHolder& value);
     };
 
     //  
     struct Method {
         //  
-        std::string name;
+        Symbol name;
         //    
-        std::vector<std::string> formal_params;
+        std::vector<Symbol> formal_params;
         //  
         std::unique_ptr<Executable> body;
+        //    .  ,    
+        //        Closure
+        size_t frame_size = 0;
+    };
+
+    /*
+     *  ( ) :     .
+     *         ,  , 
+     *        ,  .    
+     *    :       
+     */
+    class Shape {
+    public:
+        static constexpr size_t NO_FIELD = static_cast<size_t>(-1);
+
+        Shape() = default;
+        Shape(const Shape&) = delete;
+        Shape& operator=(const Shape&) = delete;
+
+        //    name  NO_FIELD
+        [[nodiscard]] size_t Find(Symbol name) const;
+        //        name,     
+        [[nodiscard]] const Shape* Extend(Symbol name) const;
+
+        [[nodiscard]] size_t GetFieldCount() const;
+        [[nodiscard]] const std::string& GetFieldName(size_t index) const;
+        //      ,   
+        [[nodiscard]] size_t GetMaxFieldCount() const;
+
+    private:
+        Shape(const Shape* root, std::vector<Symbol> names);
+
+        const Shape* root_ = this;
+        std::vector<Symbol> names_;
+        std::unordered_map<Symbol, size_t> indices_;
+        mutable std::unordered_map<Symbol, std::unique_ptr<Shape>> transitions_;
+        //     
+        mutable size_t max_field_count_ = 0;
+    };
+
+    /*
+     *   :        .
+     *  ,   Closure,      
+     */
+    class InstanceFields {
+        template <typename Owner, typename Holder>
+        class Iterator {
+        public:
+            using value_type = std::pair<const std::string&, Holder&>;
+
+            struct Arrow {
+                value_type pair;
+                const value_type* operator->() const {
+                    return &pair;
+                }
+            };
+
+            Iterator(Owner* owner, size_t index)
+                : owner_(owner)
+                , index_(index) {
+            }
+
+            value_type operator*() const {
+                return { owner_->shape_->GetFieldName(index_), owner_->values_[index_] };
+            }
+
+            Arrow operator->() const {
+                return { **this };
+            }
+
+            Iterator& operator++() {
+                ++index_;
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const {
+                return owner_ == other.owner_ && index_ == other.index_;
+            }
+
+            bool operator!=(const Iterator& other) const {
+                return !(*this == other);
+            }
+
+        private:
+            Owner* owner_;
+            size_t index_;
+        };
+
+    public:
+        using iterator = Iterator<InstanceFields, ObjectHolder>;
+        using const_iterator = Iterator<const InstanceFields, const ObjectHolder>;
+
+        explicit InstanceFields(const Shape* shape);
+
+        //   name,     None  
+        ObjectHolder& operator[](Symbol name);
+        //   name    std::out_of_range
+        ObjectHolder& at(Symbol name);
+        const ObjectHolder& at(Symbol name) const;
+
+        [[nodiscard]] iterator find(Symbol name);
+        [[nodiscard]] const_iterator find(Symbol name) const;
+        [[nodiscard]] size_t count(Symbol name) const;
+
+        [[nodiscard]] iterator begin();
+        [[nodiscard]] iterator end();
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator end() const;
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] const Shape* GetShape() const;
+
+    private:
+        friend class FieldCache;
+
+        const Shape* shape_;
+        std::vector<ObjectHolder> values_;
+    };
+
+    //        .     
+    //          
+    class FieldCache {
+    public:
+        //   name  nullptr,   
+        ObjectHolder* Find(InstanceFields& fields, Symbol name);
+        //   name,     None  
+        ObjectHolder& Emplace(InstanceFields& fields, Symbol name);
+
+    private:
+        const Shape* shape_ = nullptr;
+        size_t index_ = 0;
+        const Shape* added_from_ = nullptr;
+        const Shape* added_to_ = nullptr;
     };
 
     // 
@@ -137,22 +393,56 @@ namespace runtime {
         explicit Class(std::string name, std::vector<Method> methods, const Class* parent);
 
         //     name  nullptr,      
-        [[nodiscard]] const Method* GetMethod(const std::string& name) const;
+        [[nodiscard]] const Method* GetMethod(Symbol name) const;
+        //     name,  argument_count ,  nullptr
+        [[nodiscard]] const Method* GetMethod(Symbol name, size_t argument_count) const;
 
         //   
         [[nodiscard]] const std::string& GetName() const;
 
+        //     nullptr
+        [[nodiscard]] const Class* GetParent() const;
+        //       .   ,
+        //        
+        void SetParent(const Class* parent);
+
+        //  ,     
+        [[nodiscard]] const std::vector<Method>& GetOwnMethods() const;
+
+        //  fn     ,    ,    
+        // .    ,     
+        template <typename Fn>
+        void ForEachMethodBody(Fn&& fn) {
+            for (Method& method : methods_) {
+                fn(method.body);
+            }
+        }
+
+        //    ,      
+        [[nodiscard]] const Shape* GetRootShape() const;
+
         //   os  "Class < >",  "Class cat"
         void Print(std::ostream& os, [[maybe_unused]] Context& context) override;
 
     private:
+        struct MethodEntry {
+            const Method* method;
+            size_t arity;
+        };
+
+        void BuildMethodTable();
+
         std::string name_;
         std::vector<Method> methods_;
         const Class* parent_;
+        //      ,    
+        std::unordered_map<Symbol, MethodEntry> method_table_;
+        //    .   ,       
+        std::unique_ptr<Shape> root_shape_ = std::make_unique<Shape>();
     };
 
     //  
-    class ClassInstance : public Object {
+    class ClassInstance : public Object, public std::enable_shared_from_this<ClassInstance> {
     public:
         explicit ClassInstance(const Class& cls);
 
@@ -168,20 +458,79 @@ namespace runtime {
          *    ,       method,   
          * runtime_error
          */
-        ObjectHolder Call(const std::string& method, const std::vector<ObjectHolder>& actual_args,
+        ObjectHolder Call(Symbol method, const std::vector<ObjectHolder>& actual_args,
             [[maybe_unused]] Context& context);
+        //      
+        ObjectHolder Call(const Method& method, const std::vector<ObjectHolder>& actual_args,
+            Context& context);
+        //    ,  arg_count ,   actual_args.
+        //           
+        ObjectHolder Call(const Method& method, const ObjectHolder* actual_args, size_t arg_count,
+            Context& context);
+        //    ,      body,    
+        ObjectHolder Call(const Method& method, Executable& body, const ObjectHolder* actual_args,
+            size_t arg_count, Context& context);
 
         //  true,     method,  argument_count 
-        [[nodiscard]] bool HasMethod(const std::string& method, size_t argument_count) const;
+        [[nodiscard]] bool HasMethod(Symbol method, size_t argument_count) const;
+
+        //     
+        [[nodiscard]] InstanceFields& Fields();
+        //      
+        [[nodiscard]] const InstanceFields& Fields() const;
 
-        //    Closure,   
-        [[nodiscard]] Closure& Fields();
-        //     Closure,   
-        [[nodiscard]] const Closure& Fields() const;
+        //  ,    
+        [[nodiscard]] const Class& GetClass() const;
 
     private:
+        //   self   : ,    ObjectHolder,
+        //      self   
+        ObjectHolder MakeSelf();
+
+        //  ,      
+        ObjectHolder CallWithFrame(const Method& method, Executable& body, const ObjectHolder* actual_args,
+            size_t arg_count, Context& context);
+
         const Class& cls_;
-        Closure fields_;
+        InstanceFields fields_;
+    };
+
+    /*
+     *     . ,       ,
+     *              .
+     *       ,  ;    
+     *       CAPACITY ,    .
+     *           ,    
+     */
+    class MethodCache {
+    public:
+        struct Stats {
+            size_t hits = 0;
+            size_t misses = 0;
+        };
+
+        static constexpr size_t CAPACITY = 4;
+
+        //   name  cls,  argument_count ,  nullptr
+        const Method* Lookup(const Class& cls, Symbol name, size_t argument_count);
+
+        //       
+        [[nodiscard]] const Stats& GetStats() const;
+        //   ,     
+        [[nodiscard]] size_t GetSize() const;
+
+        //     ,    
+        static Stats& TotalStats();
+
+    private:
+        struct Entry {
+            const Class* cls = nullptr;
+            const Method* method = nullptr;
+        };
+
+        Entry entries_[CAPACITY];
+        size_t size_ = 0;
+        Stats stats_;
     };
 
     /*
@@ -203,15 +552,119 @@ namespace runtime {
      *  context      __lt__
      */
     bool Less(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    //  ,  Equal(lhs, rhs, context)
+    //  lhs -    __ne__,    .
+    //   ,  Equal(lhs, rhs, context)
     bool NotEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    //   lhs>rhs,   Equal  Less
+    /*
+     *   lhs>rhs.  lhs -    __gt__,  ,   rhs - 
+     *   __lt__,  rhs.__lt__(lhs).      Equal  Less
+     */
     bool Greater(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    //   lhs<=rhs,   Equal  Less
+    //  lhs -    __le__,    .
+    //   ,  Greater(lhs, rhs, context)
     bool LessOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    //  ,  Less(lhs, rhs, context)
+    //  lhs -    __ge__,    .
+    //   ,  Less(lhs, rhs, context)
     bool GreaterOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
 
+    //   
+    enum class CompareOp : std::uint8_t {
+        Equal,
+        NotEqual,
+        Less,
+        Greater,
+        LessOrEqual,
+        GreaterOrEqual,
+    };
+
+    /*
+     *   ,         op
+     *    ,   ,     .
+     * ,   __ne__  !=    __eq__
+     */
+    struct ComparisonMethod {
+        // nullptr,          
+        const Method* method = nullptr;
+        bool negate = false;
+    };
+
+    ComparisonMethod FindComparisonMethod(const Class& cls, CompareOp op);
+
+    //      Op
+    template <CompareOp Op, typename T>
+    bool CompareValues(const T& lhs, const T& rhs) {
+        if constexpr (Op == CompareOp::Equal) {
+            return lhs == rhs;
+        }
+        else if constexpr (Op == CompareOp::NotEqual) {
+            return lhs != rhs;
+        }
+        else if constexpr (Op == CompareOp::Less) {
+            return lhs < rhs;
+        }
+        else if constexpr (Op == CompareOp::Greater) {
+            return lhs > rhs;
+        }
+        else if constexpr (Op == CompareOp::LessOrEqual) {
+            return lhs <= rhs;
+        }
+        else {
+            return lhs >= rhs;
+        }
+    }
+
+    //  lhs  rhs  Op. ,       ,
+    //      
+    template <CompareOp Op>
+    bool Compare(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        const Object* l = lhs.Get();
+        const Object* r = rhs.Get();
+        if (l != nullptr && r != nullptr && l->GetKind() == r->GetKind()) {
+            switch (l->GetKind()) {
+            case ObjectKind::Number:
+                return CompareValues<Op>(static_cast<const Number*>(l)->GetValue(),
+                    static_cast<const Number*>(r)->GetValue());
+            case ObjectKind::String:
+                return CompareValues<Op>(static_cast<const String*>(l)->GetValue(),
+                    static_cast<const String*>(r)->GetValue());
+            case ObjectKind::Bool:
+                return CompareValues<Op>(static_cast<const Bool*>(l)->GetValue(),
+                    static_cast<const Bool*>(r)->GetValue());
+            default:
+                break;
+            }
+        }
+        if constexpr (Op == CompareOp::Equal) {
+            return Equal(lhs, rhs, context);
+        }
+        else if constexpr (Op == CompareOp::NotEqual) {
+            return NotEqual(lhs, rhs, context);
+        }
+        else if constexpr (Op == CompareOp::Less) {
+            return Less(lhs, rhs, context);
+        }
+        else if constexpr (Op == CompareOp::Greater) {
+            return Greater(lhs, rhs, context);
+        }
+        else if constexpr (Op == CompareOp::LessOrEqual) {
+            return LessOrEqual(lhs, rhs, context);
+        }
+        else {
+            return GreaterOrEqual(lhs, rhs, context);
+        }
+    }
+
+    /*
+     *     Mython.
+     * Add   ,      __add__,
+     *      .
+     *         runtime_error
+     */
+    ObjectHolder Add(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
+    ObjectHolder Sub(const ObjectHolder& lhs, const ObjectHolder& rhs);
+    ObjectHolder Mult(const ObjectHolder& lhs, const ObjectHolder& rhs);
+    ObjectHolder Div(const ObjectHolder& lhs, const ObjectHolder& rhs);
+
     // -,   .
     //           output
     struct DummyContext : Context {
@@ -2,6 +2,7 @@
 #include "test_runner_p.h"
 
 #include <functional>
+#include <thread>
 
 using namespace std;
 
@@ -19,13 +20,15 @@ namespace runtime {
             }
 
             Logger(const Logger& rhs)
-                : id_(rhs.id_)  //
+                : Object(rhs)
+                , id_(rhs.id_)  //
             {
                 ++instance_count;
             }
 
             Logger(Logger&& rhs) noexcept
-                : id_(rhs.id_)  //
+                : Object(rhs)
+                , id_(rhs.id_)  //
             {
                 ++instance_count;
             }
@@ -248,6 +251,53 @@ namespace runtime {
             ASSERT(!oh.Get());
         }
 
+        void TestImmediateValues() {
+            ObjectHolder number = ObjectHolder::Own(Number{ 42 });
+            ObjectHolder boolean = ObjectHolder::Own(Bool{ true });
+            ASSERT(number && boolean);
+            ASSERT(number.TryAs<Number>() != nullptr && number.TryAs<Number>()->GetValue() == 42);
+            ASSERT(boolean.TryAs<Bool>() != nullptr && boolean.TryAs<Bool>()->GetValue());
+            ASSERT(number.TryAs<Bool>() == nullptr);
+            ASSERT(boolean.TryAs<Number>() == nullptr);
+
+            //    ObjectHolder,       
+            ObjectHolder copy = number;
+            ASSERT(copy.Get() != number.Get());
+            number = ObjectHolder::None();
+            ASSERT(!number);
+            ASSERT_EQUAL(copy.TryAs<Number>()->GetValue(), 42);
+
+            DummyContext context;
+            copy->Print(context.output, context);
+            boolean->Print(context.output, context);
+            ASSERT_EQUAL(context.output.str(), "42True"s);
+
+            // Share -    
+            Number external(7);
+            ASSERT(ObjectHolder::Share(external).Get() == &external);
+        }
+
+        void TestPoolReusesBlocksOfFinishedThreads() {
+            // ,      ,      
+            struct Block {
+                char data[248];
+            };
+            PoolAllocator<Block> allocator;
+            Block* released = nullptr;
+            std::thread([&allocator, &released] {
+                released = allocator.allocate(1);
+                allocator.deallocate(released, 1);
+            }).join();
+
+            //       ,   
+            Block* reused = nullptr;
+            std::thread([&allocator, &reused] {
+                reused = allocator.allocate(1);
+                allocator.deallocate(reused, 1);
+            }).join();
+            ASSERT(reused == released);
+        }
+
         void TestIsTrue() {
             {
                 ASSERT(!IsTrue(ObjectHolder::Own(Bool{ false })));
@@ -474,6 +524,80 @@ namespace runtime {
             }
         }
 
+        void TestComparisonMethods() {
+            DummyContext ctx;
+            vector<string> calls;
+            auto make_method = [&calls](const string& name, bool result) {
+                return Method{ name, {"rhs"s}, make_unique<TestMethodBody>([&calls, name, result](Closure&, Context&) {
+                    calls.push_back(name);
+                    return ObjectHolder::Own(Bool{ result });
+                }) };
+            };
+
+            //      
+            vector<Method> full_methods;
+            full_methods.push_back(make_method("__eq__"s, false));
+            full_methods.push_back(make_method("__lt__"s, false));
+            full_methods.push_back(make_method("__ne__"s, true));
+            full_methods.push_back(make_method("__gt__"s, true));
+            full_methods.push_back(make_method("__le__"s, false));
+            full_methods.push_back(make_method("__ge__"s, true));
+            Class full{ "Full"s, std::move(full_methods), nullptr };
+            const auto lhs = ObjectHolder::Own(ClassInstance{ full });
+            const auto rhs = ObjectHolder::Own(Number{ 1 });
+
+            ASSERT(NotEqual(lhs, rhs, ctx));
+            ASSERT(Greater(lhs, rhs, ctx));
+            ASSERT(!LessOrEqual(lhs, rhs, ctx));
+            ASSERT(GreaterOrEqual(lhs, rhs, ctx));
+            ASSERT(Compare<CompareOp::Greater>(lhs, rhs, ctx));
+            ASSERT((calls == vector<string>{ "__ne__"s, "__gt__"s, "__le__"s, "__ge__"s, "__gt__"s }));
+
+            //  __gt__  __le__     __lt__  
+            calls.clear();
+            vector<Method> ordered_methods;
+            ordered_methods.push_back(make_method("__eq__"s, false));
+            ordered_methods.push_back(make_method("__lt__"s, true));
+            Class ordered{ "Ordered"s, std::move(ordered_methods), nullptr };
+            const auto a = ObjectHolder::Own(ClassInstance{ ordered });
+            const auto b = ObjectHolder::Own(ClassInstance{ ordered });
+            ASSERT(Greater(a, b, ctx));
+            ASSERT(!LessOrEqual(a, b, ctx));
+            ASSERT(!GreaterOrEqual(a, b, ctx));
+            ASSERT((calls == vector<string>{ "__lt__"s, "__lt__"s, "__lt__"s }));
+        }
+
+        void TestCompareMatchesComparisonFunctions() {
+            DummyContext ctx;
+            const ObjectHolder values[] = {
+                ObjectHolder::Own(Number{ 1 }), ObjectHolder::Own(Number{ 2 }),
+                ObjectHolder::Own(String{ "a"s }), ObjectHolder::Own(String{ "b"s }),
+                ObjectHolder::Own(Bool{ false }), ObjectHolder::Own(Bool{ true }), ObjectHolder::None(),
+            };
+            //    Compare    ,    
+            auto check = [&ctx](auto compare, auto function, const ObjectHolder& lhs, const ObjectHolder& rhs) {
+                bool expected = false;
+                try {
+                    expected = function(lhs, rhs, ctx);
+                }
+                catch (const runtime_error&) {
+                    ASSERT_THROWS(compare(lhs, rhs, ctx), runtime_error);
+                    return;
+                }
+                ASSERT_EQUAL(compare(lhs, rhs, ctx), expected);
+            };
+            for (const ObjectHolder& lhs : values) {
+                for (const ObjectHolder& rhs : values) {
+                    check(Compare<CompareOp::Equal>, Equal, lhs, rhs);
+                    check(Compare<CompareOp::NotEqual>, NotEqual, lhs, rhs);
+                    check(Compare<CompareOp::Less>, Less, lhs, rhs);
+                    check(Compare<CompareOp::Greater>, Greater, lhs, rhs);
+                    check(Compare<CompareOp::LessOrEqual>, LessOrEqual, lhs, rhs);
+                    check(Compare<CompareOp::GreaterOrEqual>, GreaterOrEqual, lhs, rhs);
+                }
+            }
+        }
+
         void TestClass() {
             vector<Method> methods;
             Closure* passed_closure = nullptr;
@@ -529,6 +653,108 @@ namespace runtime {
             ASSERT_THROWS(instance.Call("missing_method"s, {}, ctx), runtime_error);
         }
 
+        void TestMethodTable() {
+            auto returns = [](int value) {
+                return make_unique<TestMethodBody>([value](Closure&, Context&) {
+                    return ObjectHolder::Own(Number{ value });
+                });
+            };
+
+            vector<Method> base_methods;
+            base_methods.push_back({ "inherited"s, {}, returns(1) });
+            base_methods.push_back({ "overridden"s, {}, returns(2) });
+            Class base{ "Base"s, move(base_methods), nullptr };
+
+            vector<Method> derived_methods;
+            derived_methods.push_back({ "overridden"s, {"arg"s}, returns(3) });
+            derived_methods.push_back({ "overridden"s, {}, returns(4) });
+            Class derived{ "Derived"s, move(derived_methods), &base };
+
+            ASSERT_EQUAL(derived.GetMethod("inherited"s), base.GetMethod("inherited"s));
+            //       
+            const Method* overridden = derived.GetMethod("overridden"s);
+            ASSERT(overridden != nullptr && overridden->formal_params.size() == 1U);
+            ASSERT_EQUAL(derived.GetMethod("overridden"s, 1), overridden);
+            ASSERT_EQUAL(derived.GetMethod("overridden"s, 0), nullptr);
+            ASSERT(base.GetMethod("overridden"s, 0) != nullptr);
+
+            ClassInstance instance{ derived };
+            DummyContext ctx;
+            ASSERT(!instance.HasMethod("overridden"s, 0));
+            ASSERT_EQUAL(instance.Call("inherited"s, {}, ctx).TryAs<Number>()->GetValue(), 1);
+            auto result = instance.Call(*overridden, { ObjectHolder::None() }, ctx);
+            ASSERT_EQUAL(result.TryAs<Number>()->GetValue(), 3);
+        }
+
+        void TestInstanceShapes() {
+            Class cls{ "Point"s, {}, nullptr };
+            ClassInstance first{ cls };
+            ClassInstance second{ cls };
+            ASSERT_EQUAL(first.Fields().GetShape(), cls.GetRootShape());
+
+            first.Fields()["x"s] = ObjectHolder::Own(Number{ 1 });
+            first.Fields()["y"s] = ObjectHolder::Own(Number{ 2 });
+            second.Fields()["x"s] = ObjectHolder::Own(Number{ 3 });
+            ASSERT(first.Fields().GetShape() != second.Fields().GetShape());
+            second.Fields()["y"s] = ObjectHolder::Own(Number{ 4 });
+            // ,    ,      
+            ASSERT_EQUAL(first.Fields().GetShape(), second.Fields().GetShape());
+            ASSERT_EQUAL(cls.GetRootShape()->GetMaxFieldCount(), 2U);
+
+            ClassInstance reversed{ cls };
+            reversed.Fields()["y"s] = ObjectHolder::None();
+            reversed.Fields()["x"s] = ObjectHolder::None();
+            ASSERT(reversed.Fields().GetShape() != first.Fields().GetShape());
+
+            const InstanceFields& fields = second.Fields();
+            ASSERT_EQUAL(fields.size(), 2U);
+            ASSERT_EQUAL(fields.count("y"s), 1U);
+            ASSERT(fields.find("z"s) == fields.end());
+            ASSERT_EQUAL(fields.find("y"s)->second.TryAs<Number>()->GetValue(), 4);
+            ASSERT_THROWS(fields.at("z"s), out_of_range);
+            vector<string> names;
+            for (const auto& [name, value] : fields) {
+                names.push_back(name);
+            }
+            ASSERT_EQUAL(names, (vector<string>{ "x"s, "y"s }));
+
+            FieldCache cache;
+            ASSERT(cache.Find(first.Fields(), "z"s) == nullptr);
+            cache.Emplace(first.Fields(), "z"s) = ObjectHolder::Own(Number{ 5 });
+            cache.Emplace(second.Fields(), "z"s) = ObjectHolder::Own(Number{ 6 });
+            ASSERT_EQUAL(first.Fields().GetShape(), second.Fields().GetShape());
+            ASSERT_EQUAL(cache.Find(second.Fields(), "z"s)->TryAs<Number>()->GetValue(), 6);
+            ASSERT_EQUAL(first.Fields().at("z"s).TryAs<Number>()->GetValue(), 5);
+        }
+
+        void TestSymbols() {
+            const Symbol x{ "x"sv };
+            ASSERT(x == Symbol("x"s));
+            ASSERT_EQUAL(x.GetId(), Symbol("x").GetId());
+            ASSERT(x != Symbol("y"sv));
+            ASSERT_EQUAL(x.GetName(), "x"s);
+            ASSERT_EQUAL(Symbol().GetName(), ""s);
+
+            //                
+            const size_t count_before = Symbol::GetCount();
+            vector<vector<Symbol>> interned(4);
+            vector<thread> threads;
+            for (auto& symbols : interned) {
+                threads.emplace_back([&symbols] {
+                    for (int i = 0; i < 100; ++i) {
+                        symbols.emplace_back("__symbol_test_"s + to_string(i));
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            for (const auto& symbols : interned) {
+                ASSERT(symbols == interned.front());
+            }
+            ASSERT_EQUAL(Symbol::GetCount(), count_before + 100);
+        }
+
     }  // namespace
 
     void RunObjectsTests(TestRunner& tr) {
@@ -538,8 +764,13 @@ namespace runtime {
         RUN_TEST(tr, runtime::TestMethodInvocation);
         RUN_TEST(tr, runtime::TestIsTrue);
         RUN_TEST(tr, runtime::TestComparison);
+        RUN_TEST(tr, runtime::TestComparisonMethods);
+        RUN_TEST(tr, runtime::TestCompareMatchesComparisonFunctions);
         RUN_TEST(tr, runtime::TestClass);
         RUN_TEST(tr, runtime::TestClassInstance);
+        RUN_TEST(tr, runtime::TestMethodTable);
+        RUN_TEST(tr, runtime::TestInstanceShapes);
+        RUN_TEST(tr, runtime::TestSymbols);
     }
 
     void RunObjectHolderTests(TestRunner& tr) {
@@ -547,6 +778,8 @@ namespace runtime {
         RUN_TEST(tr, runtime::TestOwning);
         RUN_TEST(tr, runtime::TestMove);
         RUN_TEST(tr, runtime::TestNullptr);
+        RUN_TEST(tr, runtime::TestImmediateValues);
+        RUN_TEST(tr, runtime::TestPoolReusesBlocksOfFinishedThreads);
     }
 
 }  // namespace runtime
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "scan.h"
+
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define MYTHON_SCAN_X86
+#endif
+
+using namespace std;
+
+namespace parse::scan {
+
+    namespace {
+
+        bool IsIdChar(unsigned char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        size_t CountSpacesScalar(const char* begin, const char* end) {
+            const char* p = begin;
+            while (p != end && *p == ' ') {
+                ++p;
+            }
+            return static_cast<size_t>(p - begin);
+        }
+
+        size_t CountIdCharsScalar(const char* begin, const char* end) {
+            const char* p = begin;
+            while (p != end && IsIdChar(static_cast<unsigned char>(*p))) {
+                ++p;
+            }
+            return static_cast<size_t>(p - begin);
+        }
+
+        const char* FindNewlineScalar(const char* begin, const char* end) {
+            const char* p = begin;
+            while (p != end && *p != '\n') {
+                ++p;
+            }
+            return p;
+        }
+
+#ifdef MYTHON_SCAN_X86
+
+        //    SIMD- .   0x80 - lo   [lo, hi]
+        //    ,       
+        constexpr char RangeBias(char lo) {
+            return static_cast<char>(0x80 - static_cast<unsigned char>(lo));
+        }
+
+        constexpr char RangeLimit(char lo, char hi) {
+            return static_cast<char>(-128 + (hi - lo) + 1);
+        }
+
+        __attribute__((target("sse2"))) __m128i InRangeSse2(__m128i chars, char lo, char hi) {
+            const __m128i shifted = _mm_add_epi8(chars, _mm_set1_epi8(RangeBias(lo)));
+            return _mm_cmplt_epi8(shifted, _mm_set1_epi8(RangeLimit(lo, hi)));
+        }
+
+        __attribute__((target("sse2"))) unsigned IdCharMaskSse2(__m128i chars) {
+            const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+            const __m128i letters = InRangeSse2(lower, 'a', 'z');
+            const __m128i digits = InRangeSse2(chars, '0', '9');
+            const __m128i underscores = _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'));
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), underscores)));
+        }
+
+        __attribute__((target("sse2"))) size_t CountSpacesSse2(const char* begin, const char* end) {
+            const __m128i spaces = _mm_set1_epi8(' ');
+            const char* p = begin;
+            for (; end - p >= 16; p += 16) {
+                const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const unsigned others = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, spaces))) & 0xFFFFu;
+                if (others != 0) {
+                    return static_cast<size_t>(p - begin) + __builtin_ctz(others);
+                }
+            }
+            return static_cast<size_t>(p - begin) + CountSpacesScalar(p, end);
+        }
+
+        __attribute__((target("sse2"))) size_t CountIdCharsSse2(const char* begin, const char* end) {
+            const char* p = begin;
+            for (; end - p >= 16; p += 16) {
+                const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const unsigned others = ~IdCharMaskSse2(chars) & 0xFFFFu;
+                if (others != 0) {
+                    return static_cast<size_t>(p - begin) + __builtin_ctz(others);
+                }
+            }
+            return static_cast<size_t>(p - begin) + CountIdCharsScalar(p, end);
+        }
+
+        __attribute__((target("sse2"))) const char* FindNewlineSse2(const char* begin, const char* end) {
+            const __m128i newlines = _mm_set1_epi8('\n');
+            const char* p = begin;
+            for (; end - p >= 16; p += 16) {
+                const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const unsigned found = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, newlines)));
+                if (found != 0) {
+                    return p + __builtin_ctz(found);
+                }
+            }
+            return FindNewlineScalar(p, end);
+        }
+
+        __attribute__((target("avx2"))) __m256i InRangeAvx2(__m256i chars, char lo, char hi) {
+            const __m256i shifted = _mm256_add_epi8(chars, _mm256_set1_epi8(RangeBias(lo)));
+            return _mm256_cmpgt_epi8(_mm256_set1_epi8(RangeLimit(lo, hi)), shifted);
+        }
+
+        __attribute__((target("avx2"))) uint32_t IdCharMaskAvx2(__m256i chars) {
+            const __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+            const __m256i letters = InRangeAvx2(lower, 'a', 'z');
+            const __m256i digits = InRangeAvx2(chars, '0', '9');
+            const __m256i underscores = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_'));
+            return static_cast<uint32_t>(
+                _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letters, digits), underscores)));
+        }
+
+        __attribute__((target("avx2"))) size_t CountSpacesAvx2(const char* begin, const char* end) {
+            const __m256i spaces = _mm256_set1_epi8(' ');
+            const char* p = begin;
+            for (; end - p >= 32; p += 32) {
+                const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const uint32_t others = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, spaces)));
+                if (others != 0) {
+                    return static_cast<size_t>(p - begin) + __builtin_ctz(others);
+                }
+            }
+            return static_cast<size_t>(p - begin) + CountSpacesSse2(p, end);
+        }
+
+        __attribute__((target("avx2"))) size_t CountIdCharsAvx2(const char* begin, const char* end) {
+            const char* p = begin;
+            for (; end - p >= 32; p += 32) {
+                const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const uint32_t others = ~IdCharMaskAvx2(chars);
+                if (others != 0) {
+                    return static_cast<size_t>(p - begin) + __builtin_ctz(others);
+                }
+            }
+            return static_cast<size_t>(p - begin) + CountIdCharsSse2(p, end);
+        }
+
+        __attribute__((target("avx2"))) const char* FindNewlineAvx2(const char* begin, const char* end) {
+            const __m256i newlines = _mm256_set1_epi8('\n');
+            const char* p = begin;
+            for (; end - p >= 32; p += 32) {
+                const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const uint32_t found = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, newlines)));
+                if (found != 0) {
+                    return p + __builtin_ctz(found);
+                }
+            }
+            return FindNewlineSse2(p, end);
+        }
+
+#endif  // MYTHON_SCAN_X86
+
+        struct Scanners {
+            Isa isa;
+            size_t (*count_spaces)(const char*, const char*);
+            size_t (*count_id_chars)(const char*, const char*);
+            const char* (*find_newline)(const char*, const char*);
+        };
+
+        Scanners MakeScanners(Isa isa) {
+            switch (isa) {
+#ifdef MYTHON_SCAN_X86
+            case Isa::Avx2:
+                return { isa, CountSpacesAvx2, CountIdCharsAvx2, FindNewlineAvx2 };
+            case Isa::Sse2:
+                return { isa, CountSpacesSse2, CountIdCharsSse2, FindNewlineSse2 };
+#endif
+            default:
+                return { Isa::Scalar, CountSpacesScalar, CountIdCharsScalar, FindNewlineScalar };
+            }
+        }
+
+        Scanners& ActiveScanners() {
+            static Scanners scanners = MakeScanners(
+                IsSupported(Isa::Avx2) ? Isa::Avx2 : IsSupported(Isa::Sse2) ? Isa::Sse2 : Isa::Scalar);
+            return scanners;
+        }
+
+    }  // namespace
+
+    size_t CountSpaces(const char* begin, const char* end) {
+        return ActiveScanners().count_spaces(begin, end);
+    }
+
+    size_t CountIdChars(const char* begin, const char* end) {
+        return ActiveScanners().count_id_chars(begin, end);
+    }
+
+    const char* FindNewline(const char* begin, const char* end) {
+        return ActiveScanners().find_newline(begin, end);
+    }
+
+    Isa GetIsa() {
+        return ActiveScanners().isa;
+    }
+
+    bool SetIsa(Isa isa) {
+        if (!IsSupported(isa)) {
+            return false;
+        }
+        ActiveScanners() = MakeScanners(isa);
+        return true;
+    }
+
+    bool IsSupported(Isa isa) {
+#ifdef MYTHON_SCAN_X86
+        __builtin_cpu_init();
+#endif
+        switch (isa) {
+        case Isa::Scalar:
+            return true;
+#ifdef MYTHON_SCAN_X86
+        case Isa::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    string_view GetIsaName(Isa isa) {
+        switch (isa) {
+        case Isa::Scalar:
+            return "scalar"sv;
+        case Isa::Sse2:
+            return "sse2"sv;
+        case Isa::Avx2:
+            return "avx2"sv;
+        }
+        return "unknown"sv;
+    }
+
+}  // namespace parse::scan
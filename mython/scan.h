@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace parse::scan {
+
+    //  ,   
+    enum class Isa {
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    //       [begin, end)
+    std::size_t CountSpaces(const char* begin, const char* end);
+    //      ( ,   '_')   [begin, end)
+    std::size_t CountIdChars(const char* begin, const char* end);
+    //      '\n'  [begin, end)  end
+    const char* FindNewline(const char* begin, const char* end);
+
+    //   ,   .   
+    //   ,  
+    Isa GetIsa();
+    //      isa.  false,     .
+    //            
+    bool SetIsa(Isa isa);
+    [[nodiscard]] bool IsSupported(Isa isa);
+    [[nodiscard]] std::string_view GetIsaName(Isa isa);
+
+}  // namespace parse::scan
@@ -0,0 +1,69 @@
+#include "source_file.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MYTHON_HAS_MMAP
+#endif
+
+using namespace std;
+
+namespace parse {
+
+    namespace {
+
+        string ReadWholeFile(const string& path) {
+            ifstream input(path, ios::binary);
+            if (!input) {
+                throw runtime_error("Can't open file "s + path);
+            }
+            return string(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+        }
+
+    }  // namespace
+
+    SourceFile::SourceFile(const string& path) {
+#ifdef MYTHON_HAS_MMAP
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Can't open file "s + path);
+        }
+        struct stat info {};
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                mapping_ = mapping;
+                size_ = static_cast<size_t>(info.st_size);
+            }
+        }
+        close(fd);
+        if (mapping_ != nullptr) {
+            return;
+        }
+#endif
+        //  ,   ,    ,   
+        buffer_ = ReadWholeFile(path);
+    }
+
+    SourceFile::~SourceFile() {
+#ifdef MYTHON_HAS_MMAP
+        if (mapping_ != nullptr) {
+            munmap(mapping_, size_);
+        }
+#endif
+    }
+
+    string_view SourceFile::GetText() const {
+        if (mapping_ != nullptr) {
+            return { static_cast<const char*>(mapping_), size_ };
+        }
+        return buffer_;
+    }
+
+}  // namespace parse
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace parse {
+
+    /*
+     *  ,   .  POSIX-    
+     *  mmap   ,       .
+     * ,  GetText, ,   
+     */
+    class SourceFile {
+    public:
+        //   path.     ,  std::runtime_error
+        explicit SourceFile(const std::string& path);
+        ~SourceFile();
+
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+
+        [[nodiscard]] std::string_view GetText() const;
+
+    private:
+        //      nullptr,     buffer_
+        void* mapping_ = nullptr;
+        size_t size_ = 0;
+        std::string buffer_;
+    };
+
+}  // namespace parse
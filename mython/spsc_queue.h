@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace parse {
+
+    /*
+     *       -   -.
+     * TryPush   , TryPop -  .
+     *     ,     
+     */
+    template <typename T, std::size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        //  value  .  false,   
+        bool TryPush(const T& value) {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cached_head_ == Capacity) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ == Capacity) {
+                    return false;
+                }
+            }
+            slots_[tail & MASK] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        //    value.  false,   
+        bool TryPop(T& value) {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cached_tail_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head == cached_tail_) {
+                    return false;
+                }
+            }
+            value = slots_[head & MASK];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        static constexpr std::size_t MASK = Capacity - 1;
+        //   .        ,
+        //           
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+        //  
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{ 0 };
+        //     tail_
+        std::size_t cached_tail_ = 0;
+
+        //  
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{ 0 };
+        //     head_
+        std::size_t cached_head_ = 0;
+
+        alignas(CACHE_LINE_SIZE) std::array<T, Capacity> slots_{};
+    };
+
+}  // namespace parse
@@ -12,47 +12,99 @@ namespace ast {
     using runtime::ObjectHolder;
 
     namespace {
-        const string ADD_METHOD = "__add__"s;
-        const string INIT_METHOD = "__init__"s;
+        const runtime::Symbol INIT_METHOD{ "__init__"sv };
+        const runtime::Symbol ADD_METHOD{ "__add__"sv };
+
+        //  node  EvaluateInt      ObjectHolder
+        ObjectHolder ExecuteAsInt(Statement& node, Closure& closure, Context& context) {
+            int number = 0;
+            ObjectHolder value;
+            if (node.EvaluateInt(closure, context, number, value)) {
+                return ObjectHolder::Own(runtime::Number(number));
+            }
+            return value;
+        }
+
+        void PrintValue(const ObjectHolder& obj, std::ostream& os, Context& context) {
+            if (obj.Get()) {
+                obj->Print(os, context);
+            }
+            else {
+                os << "None"s;
+            }
+        }
     }  // namespace
 
     ObjectHolder Assignment::Execute(Closure& closure, Context& context) {
         ObjectHolder obj = rv_->Execute(closure, context);
+        if (slot_ != NO_SLOT) {
+            runtime::LocalSlot& local = context.GetFrame()[slot_];
+            local = { std::move(obj), true };
+            return local.value;
+        }
         closure[var_] = std::move(obj);
         return closure.at(var_);
     }
 
-    Assignment::Assignment(std::string var, std::unique_ptr<Statement> rv)
+    Assignment::Assignment(runtime::Symbol var, std::unique_ptr<Statement> rv)
+        : var_(var)
+        , rv_(std::move(rv)) {
+    }
+
+    Assignment::Assignment(runtime::Symbol var, size_t slot, std::unique_ptr<Statement> rv)
         : var_(var)
+        , slot_(slot)
         , rv_(std::move(rv)) {
     }
 
-    VariableValue::VariableValue(const std::string& var_name) {
+    VariableValue::VariableValue(runtime::Symbol var_name) {
         ids_.push_back(var_name);
     }
 
-    VariableValue::VariableValue(std::vector<std::string> dotted_ids) 
-        : ids_(std::move(dotted_ids)) {
+    VariableValue::VariableValue(const std::vector<std::string>& dotted_ids)
+        : VariableValue(std::vector<runtime::Symbol>(dotted_ids.begin(), dotted_ids.end()), NO_SLOT) {
+    }
+
+    VariableValue::VariableValue(std::vector<runtime::Symbol> dotted_ids) 
+        : VariableValue(std::move(dotted_ids), NO_SLOT) {
+    }
+
+    VariableValue::VariableValue(std::vector<runtime::Symbol> dotted_ids, size_t slot)
+        : ids_(std::move(dotted_ids))
+        , slot_(slot)
+        , field_caches_(ids_.empty() ? 0 : ids_.size() - 1) {
     }
 
     ObjectHolder VariableValue::Execute(Closure& closure, [[maybe_unused]] Context& context) {
-        Closure* curr_closure = &closure;
-        std::string last_id;
-        for (auto it = ids_.begin(); it != ids_.end(); ++it) {
-            auto object = curr_closure->find(*it);
-            if (object != curr_closure->end()) {
-                last_id = object->first;
-                if (object->second.TryAs<runtime::ClassInstance>()) {
-                    if (std::next(it) != ids_.end()) {
-                        curr_closure = &object->second.TryAs<runtime::ClassInstance>()->Fields();
-                    }
-                }
+        ObjectHolder object;
+        if (slot_ == NO_SLOT) {
+            auto it = closure.find(ids_.front());
+            if (it == closure.end()) {
+                throw std::runtime_error("Wrong variable!"s);
             }
+            object = it->second;
         }
-        if (curr_closure->find(last_id) != curr_closure->end()) {
-            return curr_closure->at(last_id);
+        else {
+            const runtime::LocalSlot& local = context.GetFrame()[slot_];
+            if (!local.bound) {
+                throw std::runtime_error("Wrong variable!"s);
+            }
+            object = local.value;
         }
-        throw std::runtime_error("Wrong variable!"s);
+        for (size_t i = 1; i < ids_.size(); ++i) {
+            auto* instance = object.TryAs<runtime::ClassInstance>();
+            if (instance == nullptr) {
+                throw std::runtime_error("Wrong variable!"s);
+            }
+            ObjectHolder* field = field_caches_[i - 1].Find(instance->Fields(), ids_[i]);
+            if (field == nullptr) {
+                throw std::runtime_error("Wrong variable!"s);
+            }
+            //     object,      
+            ObjectHolder next = *field;
+            object = std::move(next);
+        }
+        return object;
     }
 
     unique_ptr<Print> Print::Variable(const std::string& name) {
@@ -77,18 +129,25 @@ namespace ast {
                 os << ' ';
             }
             first_iter = false;
-            if (obj.Get()) {
-                obj->Print(os, context);
-            }
-            else {
-                os << "None"s;
-            }
+            PrintValue(obj, os, context);
         }
         os << '\n';
         return {};
     }
 
-    MethodCall::MethodCall(std::unique_ptr<Statement> object, std::string method,
+    PrintVariable::PrintVariable(VariableValue variable)
+        : variable_(std::move(variable)) {
+    }
+
+    ObjectHolder PrintVariable::Execute(Closure& closure, Context& context) {
+        ObjectHolder obj = variable_.Execute(closure, context);
+        std::ostream& os = context.GetOutputStream();
+        PrintValue(obj, os, context);
+        os << '\n';
+        return {};
+    }
+
+    MethodCall::MethodCall(std::unique_ptr<Statement> object, runtime::Symbol method,
         std::vector<std::unique_ptr<Statement>> args) 
         : object_(std::move(object))
         , method_(method) 
@@ -97,16 +156,25 @@ namespace ast {
 
     ObjectHolder MethodCall::Execute(Closure& closure, Context& context) {
         ObjectHolder obj = object_->Execute(closure, context);
-        if (obj.TryAs<runtime::ClassInstance>()->HasMethod(method_, args_.size())) {
+        auto* instance = obj.TryAs<runtime::ClassInstance>();
+        if (instance == nullptr) {
+            throw std::runtime_error("Method call on a non-object"s);
+        }
+        if (const runtime::Method* method = cache_.Lookup(instance->GetClass(), method_, args_.size())) {
             std::vector<ObjectHolder> fields;
+            fields.reserve(args_.size());
             for (const auto& arg : args_) {
                 fields.push_back(arg->Execute(closure, context));
             }
-            return obj.TryAs<runtime::ClassInstance>()->Call(method_, fields, context);
+            return instance->Call(*method, fields, context);
         }
         return ObjectHolder::None();
     }
 
+    const runtime::MethodCache& MethodCall::GetCache() const {
+        return cache_;
+    }
+
     ObjectHolder Stringify::Execute(Closure& closure, Context& context) {
         if (arg_.get()) {
             ObjectHolder obj = arg_.get()->Execute(closure, context);
@@ -119,69 +187,201 @@ namespace ast {
         return ObjectHolder::Own(runtime::String("None"s));
     }
 
+    bool BinaryOperation::EvaluateNumbers(Closure& closure, Context& context, int& lhs_number, int& rhs_number,
+        ObjectHolder& lhs, ObjectHolder& rhs) {
+        const bool lhs_is_number = lhs_->EvaluateInt(closure, context, lhs_number, lhs);
+        const bool rhs_is_number = rhs_->EvaluateInt(closure, context, rhs_number, rhs);
+        if (lhs_is_number && rhs_is_number) {
+            return true;
+        }
+        if (lhs_is_number) {
+            lhs = ObjectHolder::Own(runtime::Number(lhs_number));
+        }
+        if (rhs_is_number) {
+            rhs = ObjectHolder::Own(runtime::Number(rhs_number));
+        }
+        return false;
+    }
+
+    void TypeFeedback::Record(State observed) {
+        if (state_ != State::Warmup) {
+            return;
+        }
+        if (observed == State::Generic || (count_ > 0 && observed != observed_)) {
+            state_ = State::Generic;
+            return;
+        }
+        observed_ = observed;
+        if (++count_ < QUICKEN_THRESHOLD) {
+            return;
+        }
+        state_ = observed;
+        switch (observed) {
+        case State::Numbers:
+            ++TotalStats().numbers;
+            break;
+        case State::Strings:
+            ++TotalStats().strings;
+            break;
+        default:
+            ++TotalStats().instances;
+            break;
+        }
+    }
+
+    void TypeFeedback::RecordInstance(const runtime::Class& cls, const runtime::Method* method, bool negate) {
+        if (state_ != State::Warmup) {
+            return;
+        }
+        if (method == nullptr || (count_ > 0 && (&cls != cls_ || method != method_ || negate != negate_))) {
+            state_ = State::Generic;
+            return;
+        }
+        cls_ = &cls;
+        method_ = method;
+        negate_ = negate;
+        Record(State::Instances);
+    }
+
+    void TypeFeedback::Deoptimize() {
+        state_ = State::Generic;
+        ++TotalStats().deoptimizations;
+    }
+
+    TypeFeedback::Stats& TypeFeedback::TotalStats() {
+        thread_local Stats total;
+        return total;
+    }
+
     ObjectHolder Add::Execute(Closure& closure, Context& context) {
-        ObjectHolder lhs = lhs_->Execute(closure, context);
-        ObjectHolder rhs = rhs_->Execute(closure, context);
-        if (lhs.TryAs<runtime::Number>() && rhs.TryAs<runtime::Number>()) {
-            return ObjectHolder::Own<runtime::Number>(lhs.TryAs<runtime::Number>()->GetValue() 
-                + rhs.TryAs<runtime::Number>()->GetValue());
+        return ExecuteAsInt(*this, closure, context);
+    }
+
+    bool Add::EvaluateInt(Closure& closure, Context& context, int& number, ObjectHolder& value) {
+        using State = TypeFeedback::State;
+        const State state = feedback_.GetState();
+        ObjectHolder lhs;
+        ObjectHolder rhs;
+        if (state == State::Strings || state == State::Instances) {
+            lhs = lhs_->Execute(closure, context);
+            rhs = rhs_->Execute(closure, context);
+            if (state == State::Strings) {
+                const auto* lhs_string = lhs.TryAs<runtime::String>();
+                const auto* rhs_string = rhs.TryAs<runtime::String>();
+                if (lhs_string != nullptr && rhs_string != nullptr) {
+                    TypeFeedback::Hit();
+                    value = ObjectHolder::Own(runtime::String(lhs_string->GetValue() + rhs_string->GetValue()));
+                    return false;
+                }
+            }
+            else if (runtime::ClassInstance* instance = feedback_.MatchInstance(lhs)) {
+                TypeFeedback::Hit();
+                value = instance->Call(feedback_.GetMethod(), { rhs }, context);
+                return false;
+            }
+            feedback_.Deoptimize();
+            value = runtime::Add(lhs, rhs, context);
+            return false;
+        }
+
+        int lhs_number = 0;
+        int rhs_number = 0;
+        if (EvaluateNumbers(closure, context, lhs_number, rhs_number, lhs, rhs)) {
+            if (state == State::Numbers) {
+                TypeFeedback::Hit();
+            }
+            else {
+                feedback_.Record(State::Numbers);
+            }
+            number = lhs_number + rhs_number;
+            return true;
         }
-        if (lhs.TryAs<runtime::String>() && rhs.TryAs<runtime::String>()) {
-            return ObjectHolder::Own<runtime::String>(lhs.TryAs<runtime::String>()->GetValue()
-                + rhs.TryAs<runtime::String>()->GetValue());
+        if (state == State::Numbers) {
+            feedback_.Deoptimize();
         }
-        if (lhs.TryAs<runtime::ClassInstance>()) {
-            if (lhs.TryAs<runtime::ClassInstance>()->HasMethod(ADD_METHOD, 1)) {
-                return lhs.TryAs<runtime::ClassInstance>()->Call(ADD_METHOD, { rhs }, context);
+        else if (state == State::Warmup) {
+            if (lhs.TryAs<runtime::String>() != nullptr && rhs.TryAs<runtime::String>() != nullptr) {
+                feedback_.Record(State::Strings);
+            }
+            else if (const auto* instance = lhs.TryAs<runtime::ClassInstance>()) {
+                feedback_.RecordInstance(instance->GetClass(), instance->GetClass().GetMethod(ADD_METHOD, 1));
+            }
+            else {
+                feedback_.Record(State::Generic);
             }
         }
-        throw std::runtime_error("Addition error"s);
+        value = runtime::Add(lhs, rhs, context);
+        return false;
     }
 
     ObjectHolder Sub::Execute(Closure& closure, Context& context) {
-        ObjectHolder lhs = lhs_->Execute(closure, context);
-        ObjectHolder rhs = rhs_->Execute(closure, context);
-        if (lhs.TryAs<runtime::Number>() && rhs.TryAs<runtime::Number>()) {
-            return ObjectHolder::Own<runtime::Number>(lhs.TryAs<runtime::Number>()->GetValue()
-                - rhs.TryAs<runtime::Number>()->GetValue());
+        return ExecuteAsInt(*this, closure, context);
+    }
+
+    bool Sub::EvaluateInt(Closure& closure, Context& context, int& number, ObjectHolder& value) {
+        int lhs_number = 0;
+        int rhs_number = 0;
+        ObjectHolder lhs;
+        ObjectHolder rhs;
+        if (EvaluateNumbers(closure, context, lhs_number, rhs_number, lhs, rhs)) {
+            number = lhs_number - rhs_number;
+            return true;
         }
-        throw std::runtime_error("Substraction error"s);
+        value = runtime::Sub(lhs, rhs);
+        return false;
     }
 
     ObjectHolder Mult::Execute(Closure& closure, Context& context) {
-        ObjectHolder lhs = lhs_->Execute(closure, context);
-        ObjectHolder rhs = rhs_->Execute(closure, context);
-        if (lhs.TryAs<runtime::Number>() && rhs.TryAs<runtime::Number>()) {
-            return ObjectHolder::Own<runtime::Number>(lhs.TryAs<runtime::Number>()->GetValue()
-                * rhs.TryAs<runtime::Number>()->GetValue());
+        return ExecuteAsInt(*this, closure, context);
+    }
+
+    bool Mult::EvaluateInt(Closure& closure, Context& context, int& number, ObjectHolder& value) {
+        int lhs_number = 0;
+        int rhs_number = 0;
+        ObjectHolder lhs;
+        ObjectHolder rhs;
+        if (EvaluateNumbers(closure, context, lhs_number, rhs_number, lhs, rhs)) {
+            number = lhs_number * rhs_number;
+            return true;
         }
-        throw std::runtime_error("Multiplication error"s);
+        value = runtime::Mult(lhs, rhs);
+        return false;
     }
 
     ObjectHolder Div::Execute(Closure& closure, Context& context) {
-        ObjectHolder lhs = lhs_->Execute(closure, context);
-        ObjectHolder rhs = rhs_->Execute(closure, context);
-        if (lhs.TryAs<runtime::Number>() && rhs.TryAs<runtime::Number>()) {
-            if (rhs.TryAs<runtime::Number>()->GetValue() != 0) {
-                return ObjectHolder::Own<runtime::Number>(lhs.TryAs<runtime::Number>()->GetValue()
-                    / rhs.TryAs<runtime::Number>()->GetValue());
-            }
-            else {
+        return ExecuteAsInt(*this, closure, context);
+    }
+
+    bool Div::EvaluateInt(Closure& closure, Context& context, int& number, ObjectHolder& value) {
+        int lhs_number = 0;
+        int rhs_number = 0;
+        ObjectHolder lhs;
+        ObjectHolder rhs;
+        if (EvaluateNumbers(closure, context, lhs_number, rhs_number, lhs, rhs)) {
+            if (rhs_number == 0) {
                 throw std::runtime_error("Error. Division by zero"s);
             }
+            number = lhs_number / rhs_number;
+            return true;
         }
-        throw std::runtime_error("Division error"s);
+        value = runtime::Div(lhs, rhs);
+        return false;
     }
 
     ObjectHolder Compound::Execute(Closure& closure, Context& context) {
         for (const auto& arg : args_) {
-            arg->Execute(closure, context);
+            ObjectHolder result = arg->Execute(closure, context);
+            if (context.IsReturning()) {
+                return result;
+            }
         }
         return ObjectHolder::None();
     }
 
     ObjectHolder Return::Execute(Closure& closure, Context& context) {
-        throw(statement_->Execute(closure, context));
+        ObjectHolder result = statement_->Execute(closure, context);
+        context.SetReturning(true);
+        return result;
     }
 
     ClassDefinition::ClassDefinition(ObjectHolder cls) 
@@ -193,7 +393,7 @@ namespace ast {
         return {};
     }
 
-    FieldAssignment::FieldAssignment(VariableValue object, std::string field_name,
+    FieldAssignment::FieldAssignment(VariableValue object, runtime::Symbol field_name,
         std::unique_ptr<Statement> rv) 
         : object_(object)
         , field_name_(field_name)
@@ -202,9 +402,42 @@ namespace ast {
 
     ObjectHolder FieldAssignment::Execute(Closure& closure, Context& context) {
         ObjectHolder obj = object_.Execute(closure, context);
-        ObjectHolder statement = rv_->Execute(closure, context);
-        obj.TryAs<runtime::ClassInstance>()->Fields()[field_name_] = statement;
-        return obj.TryAs<runtime::ClassInstance>()->Fields().at(field_name_);
+        auto* instance = obj.TryAs<runtime::ClassInstance>();
+        if (instance == nullptr) {
+            throw std::runtime_error("Field assignment to a non-object"s);
+        }
+        ObjectHolder value = rv_->Execute(closure, context);
+        ObjectHolder& field = cache_.Emplace(instance->Fields(), field_name_);
+        field = std::move(value);
+        return field;
+    }
+
+    FieldIncrement::FieldIncrement(VariableValue object, runtime::Symbol field_name, int delta)
+        : object_(std::move(object))
+        , field_name_(field_name)
+        , delta_(delta) {
+    }
+
+    ObjectHolder FieldIncrement::Execute(Closure& closure, Context& context) {
+        ObjectHolder obj = object_.Execute(closure, context);
+        auto* instance = obj.TryAs<runtime::ClassInstance>();
+        if (instance == nullptr) {
+            throw std::runtime_error("Field assignment to a non-object"s);
+        }
+        ObjectHolder* field = cache_.Find(instance->Fields(), field_name_);
+        if (field == nullptr) {
+            throw std::runtime_error("Wrong variable!"s);
+        }
+        if (const auto* number = field->TryAs<runtime::Number>()) {
+            *field = ObjectHolder::Own(runtime::Number(number->GetValue() + delta_));
+            return *field;
+        }
+        //  __add__    ,   ,    
+        const ObjectHolder current = *field;
+        ObjectHolder value = runtime::Add(current, ObjectHolder::Own(runtime::Number(delta_)), context);
+        ObjectHolder& target = cache_.Emplace(instance->Fields(), field_name_);
+        target = std::move(value);
+        return target;
     }
 
     IfElse::IfElse(std::unique_ptr<Statement> condition, std::unique_ptr<Statement> if_body,
@@ -215,87 +448,122 @@ namespace ast {
     }
 
     ObjectHolder IfElse::Execute(Closure& closure, Context& context) {
-        if (runtime::IsTrue(condition_->Execute(closure, context))) {
-            try {
-                if_body_->Execute(closure, context);
-            }
-            catch (ObjectHolder obj) {
-                throw obj;
-            }
+        if (condition_->EvaluateBool(closure, context)) {
+            return if_body_->Execute(closure, context);
         }
-        else {
-            if (else_body_ != nullptr) {
-                try {
-                    else_body_->Execute(closure, context);
-                }
-                catch (ObjectHolder obj) {
-                    throw obj;
-                }
-            }
+        if (else_body_ != nullptr) {
+            return else_body_->Execute(closure, context);
         }
         return ObjectHolder::None();
     }
 
     ObjectHolder Or::Execute(Closure& closure, Context& context) {
-        ObjectHolder lhs = lhs_->Execute(closure, context);
-        if (runtime::IsTrue(lhs)) {
-            return ObjectHolder::Own<runtime::Bool>(true);
-        }
-        else {
-            ObjectHolder rhs = rhs_->Execute(closure, context);
-            if (runtime::IsTrue(rhs)) {
-                return ObjectHolder::Own<runtime::Bool>(true);
-            }
-        }
-        return ObjectHolder::Own<runtime::Bool>(false);
+        return ObjectHolder::Own<runtime::Bool>(EvaluateBool(closure, context));
+    }
+
+    bool Or::EvaluateBool(Closure& closure, Context& context) {
+        return lhs_->EvaluateBool(closure, context) || rhs_->EvaluateBool(closure, context);
     }
 
     ObjectHolder And::Execute(Closure& closure, Context& context) {
-        ObjectHolder lhs = lhs_->Execute(closure, context);
-        if (runtime::IsTrue(lhs)) {
-            ObjectHolder rhs = rhs_->Execute(closure, context);
-            if (runtime::IsTrue(rhs)) {
-                return ObjectHolder::Own<runtime::Bool>(true);
-            }
-        }
-        return ObjectHolder::Own<runtime::Bool>(false);
+        return ObjectHolder::Own<runtime::Bool>(EvaluateBool(closure, context));
+    }
+
+    bool And::EvaluateBool(Closure& closure, Context& context) {
+        return lhs_->EvaluateBool(closure, context) && rhs_->EvaluateBool(closure, context);
     }
 
     ObjectHolder Not::Execute(Closure& closure, Context& context) {
-        ObjectHolder obj = arg_->Execute(closure, context);
-        return ObjectHolder::Own<runtime::Bool>(!runtime::IsTrue(obj));
+        return ObjectHolder::Own<runtime::Bool>(EvaluateBool(closure, context));
+    }
+
+    bool Not::EvaluateBool(Closure& closure, Context& context) {
+        return !arg_->EvaluateBool(closure, context);
     }
 
     Comparison::Comparison(Comparator cmp, unique_ptr<Statement> lhs, unique_ptr<Statement> rhs)
         : BinaryOperation(std::move(lhs), std::move(rhs))
-        , cmp_(cmp){
+        , cmp_(std::move(cmp)) {
     }
 
     ObjectHolder Comparison::Execute(Closure& closure, Context& context) {
+        return ObjectHolder::Own<runtime::Bool>(EvaluateBool(closure, context));
+    }
+
+    bool Comparison::EvaluateBool(Closure& closure, Context& context) {
         ObjectHolder lhs = lhs_->Execute(closure, context);
         ObjectHolder rhs = rhs_->Execute(closure, context);
-        auto result = cmp_(lhs, rhs, context);
-        return ObjectHolder::Own<runtime::Bool>(result);
+        return cmp_(lhs, rhs, context);
+    }
+
+    void BuiltinComparison::RecordOperands(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+        if (feedback_.GetState() != TypeFeedback::State::Warmup) {
+            return;
+        }
+        if (lhs.TryAs<runtime::String>() != nullptr && rhs.TryAs<runtime::String>() != nullptr) {
+            feedback_.Record(TypeFeedback::State::Strings);
+        }
+        else if (const auto* instance = lhs.TryAs<runtime::ClassInstance>()) {
+            const runtime::ComparisonMethod method = runtime::FindComparisonMethod(instance->GetClass(), op_);
+            feedback_.RecordInstance(instance->GetClass(), method.method, method.negate);
+        }
+        else {
+            feedback_.Record(TypeFeedback::State::Generic);
+        }
+    }
+
+    unique_ptr<BuiltinComparison> MakeComparison(runtime::CompareOp op, unique_ptr<Statement> lhs,
+        unique_ptr<Statement> rhs) {
+        using runtime::CompareOp;
+        switch (op) {
+        case CompareOp::Equal:
+            return make_unique<Compare<CompareOp::Equal>>(std::move(lhs), std::move(rhs));
+        case CompareOp::NotEqual:
+            return make_unique<Compare<CompareOp::NotEqual>>(std::move(lhs), std::move(rhs));
+        case CompareOp::Less:
+            return make_unique<Compare<CompareOp::Less>>(std::move(lhs), std::move(rhs));
+        case CompareOp::Greater:
+            return make_unique<Compare<CompareOp::Greater>>(std::move(lhs), std::move(rhs));
+        case CompareOp::LessOrEqual:
+            return make_unique<Compare<CompareOp::LessOrEqual>>(std::move(lhs), std::move(rhs));
+        case CompareOp::GreaterOrEqual:
+            return make_unique<Compare<CompareOp::GreaterOrEqual>>(std::move(lhs), std::move(rhs));
+        }
+        throw invalid_argument("Unknown comparison operator"s);
     }
 
     NewInstance::NewInstance(const runtime::Class& class_, std::vector<std::unique_ptr<Statement>> args) 
-        : cls_inst_(runtime::ClassInstance(class_))
-        , args_(std::move(args)) {
+        : class_(&class_)
+        , args_(std::move(args))
+        , init_(class_.GetMethod(INIT_METHOD, args_.size())) {
     }
 
     NewInstance::NewInstance(const runtime::Class& class_) 
-        : cls_inst_(runtime::ClassInstance(class_)) {
+        : class_(&class_)
+        , init_(class_.GetMethod(INIT_METHOD, 0)) {
+    }
+
+    NewInstance::NewInstance(std::vector<std::unique_ptr<Statement>> args) 
+        : args_(std::move(args)) {
+    }
+
+    void NewInstance::Bind(const runtime::Class& cls) {
+        class_ = &cls;
+        init_ = cls.GetMethod(INIT_METHOD, args_.size());
     }
 
     ObjectHolder NewInstance::Execute(Closure& closure, Context& context) {
-        if (cls_inst_.HasMethod(INIT_METHOD, args_.size())) {
-            std::vector<ObjectHolder> fields;
-            for (const auto& arg : args_) {
-                fields.push_back(arg->Execute(closure, context));
-            }
-            cls_inst_.Call(INIT_METHOD, fields, context);
+        if (init_ == nullptr) {
+            return ObjectHolder::Own(runtime::ClassInstance(*class_));
+        }
+        std::vector<ObjectHolder> fields;
+        fields.reserve(args_.size());
+        for (const auto& arg : args_) {
+            fields.push_back(arg->Execute(closure, context));
         }
-        return ObjectHolder::Share(cls_inst_);
+        ObjectHolder instance = ObjectHolder::Own(runtime::ClassInstance(*class_));
+        instance.TryAs<runtime::ClassInstance>()->Call(*init_, fields, context);
+        return instance;
     }
 
     MethodBody::MethodBody(std::unique_ptr<Statement>&& body) 
@@ -303,13 +571,106 @@ namespace ast {
     }
 
     ObjectHolder MethodBody::Execute(Closure& closure, Context& context) {
-        try {
-            body_->Execute(closure, context);
-        }
-        catch (ObjectHolder obj) {
-            return obj;
+        ObjectHolder result = body_->Execute(closure, context);
+        if (context.IsReturning()) {
+            context.SetReturning(false);
+            return result;
         }
         return ObjectHolder::None();
     }
 
+    namespace {
+        void VisitAll(vector<unique_ptr<Statement>>& nodes, const ChildVisitor& visitor) {
+            for (auto& node : nodes) {
+                visitor(node);
+            }
+        }
+    }  // namespace
+
+    void Assignment::ForEachChild(const ChildVisitor& visitor) {
+        visitor(rv_);
+    }
+
+    void FieldAssignment::ForEachChild(const ChildVisitor& visitor) {
+        visitor(rv_);
+    }
+
+    void Print::ForEachChild(const ChildVisitor& visitor) {
+        VisitAll(args_, visitor);
+    }
+
+    void MethodCall::ForEachChild(const ChildVisitor& visitor) {
+        visitor(object_);
+        VisitAll(args_, visitor);
+    }
+
+    void NewInstance::ForEachChild(const ChildVisitor& visitor) {
+        VisitAll(args_, visitor);
+    }
+
+    void UnaryOperation::ForEachChild(const ChildVisitor& visitor) {
+        visitor(arg_);
+    }
+
+    void BinaryOperation::ForEachChild(const ChildVisitor& visitor) {
+        visitor(lhs_);
+        visitor(rhs_);
+    }
+
+    void Compound::ForEachChild(const ChildVisitor& visitor) {
+        VisitAll(args_, visitor);
+    }
+
+    void MethodBody::ForEachChild(const ChildVisitor& visitor) {
+        visitor(body_);
+    }
+
+    void Return::ForEachChild(const ChildVisitor& visitor) {
+        visitor(statement_);
+    }
+
+    void IfElse::ForEachChild(const ChildVisitor& visitor) {
+        visitor(condition_);
+        visitor(if_body_);
+        if (else_body_ != nullptr) {
+            visitor(else_body_);
+        }
+    }
+
+    void VisitChildren(Statement& node, const ChildVisitor& visitor) {
+        if (auto* p = dynamic_cast<Assignment*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<FieldAssignment*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<Print*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<MethodCall*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<NewInstance*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<UnaryOperation*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<BinaryOperation*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<Compound*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<MethodBody*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<Return*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+        else if (auto* p = dynamic_cast<IfElse*>(&node)) {
+            p->ForEachChild(visitor);
+        }
+    }
+
 }  // namespace ast
\ No newline at end of file
@@ -2,12 +2,27 @@
 
 #include "runtime.h"
 
+#include <cstdint>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 namespace ast {
 
     using Statement = runtime::Executable;
 
+    //   ,     ,    
+    using ChildVisitor = std::function<void(std::unique_ptr<Statement>&)>;
+
+    //  visitor   ,   node,   .
+    //     :   runtime::Class::ForEachMethodBody.
+    // ,      (,  ),    .
+    //  ,    unique_ptr,    ,    
+    void VisitChildren(Statement& node, const ChildVisitor& visitor);
+
+    //   ,    Closure,     
+    inline constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
     // ,    T,
     //      
     template <typename T>
@@ -22,6 +37,31 @@ namespace ast {
             return runtime::ObjectHolder::Share(value_);
         }
 
+        bool EvaluateBool(runtime::Closure& /*closure*/, runtime::Context& /*context*/) override {
+            if constexpr (std::is_same_v<T, runtime::String>) {
+                return !value_.GetValue().empty();
+            }
+            else {
+                return static_cast<bool>(value_.GetValue());
+            }
+        }
+
+        bool EvaluateInt(runtime::Closure& /*closure*/, runtime::Context& /*context*/, int& number,
+            runtime::ObjectHolder& value) override {
+            if constexpr (std::is_same_v<T, runtime::Number>) {
+                number = value_.GetValue();
+                return true;
+            }
+            else {
+                value = runtime::ObjectHolder::Share(value_);
+                return false;
+            }
+        }
+
+        [[nodiscard]] const T& GetValue() const {
+            return value_;
+        }
+
     private:
         T value_;
     };
@@ -34,41 +74,102 @@ namespace ast {
             id1.id2.id3.
     ,  circle.center.x -      :
     x = circle.center.x
+        slot,  id1     
     */
     class VariableValue : public Statement {
     public:
-        explicit VariableValue(const std::string& var_name);
-        explicit VariableValue(std::vector<std::string> dotted_ids);
+        explicit VariableValue(runtime::Symbol var_name);
+        explicit VariableValue(const std::vector<std::string>& dotted_ids);
+        explicit VariableValue(std::vector<runtime::Symbol> dotted_ids);
+        VariableValue(std::vector<runtime::Symbol> dotted_ids, size_t slot);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, [[maybe_unused]] runtime::Context& context) override;
 
+        [[nodiscard]] const std::vector<runtime::Symbol>& GetIds() const {
+            return ids_;
+        }
+
+        [[nodiscard]] size_t GetSlot() const {
+            return slot_;
+        }
+
     private:
-        std::vector<std::string> ids_;
+        std::vector<runtime::Symbol> ids_;
+        size_t slot_ = NO_SLOT;
+        //     ids_[1], ids_[2], ...
+        std::vector<runtime::FieldCache> field_caches_;
     };
 
-    //  ,      var,   rv
+    //  ,      var,   rv.
+    //     slot,      
     class Assignment : public Statement {
     public:
-        Assignment(std::string var, std::unique_ptr<Statement> rv);
+        Assignment(runtime::Symbol var, std::unique_ptr<Statement> rv);
+        Assignment(runtime::Symbol var, size_t slot, std::unique_ptr<Statement> rv);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, [[maybe_unused]] runtime::Context& context) override;
 
+        [[nodiscard]] runtime::Symbol GetName() const {
+            return var_;
+        }
+
+        [[nodiscard]] size_t GetSlot() const {
+            return slot_;
+        }
+
+        [[nodiscard]] Statement& GetValue() const {
+            return *rv_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
-        std::string var_;
+        runtime::Symbol var_;
+        size_t slot_ = NO_SLOT;
         std::unique_ptr<Statement> rv_;
     };
 
     //   object.field_name   rv
     class FieldAssignment : public Statement {
     public:
-        FieldAssignment(VariableValue object, std::string field_name, std::unique_ptr<Statement> rv);
+        FieldAssignment(VariableValue object, runtime::Symbol field_name, std::unique_ptr<Statement> rv);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, [[maybe_unused]] runtime::Context& context) override;
-        
+
+        [[nodiscard]] const VariableValue& GetObject() const {
+            return object_;
+        }
+
+        [[nodiscard]] runtime::Symbol GetFieldName() const {
+            return field_name_;
+        }
+
+        [[nodiscard]] Statement& GetValue() const {
+            return *rv_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
         VariableValue object_;
-        std::string field_name_;
+        runtime::Symbol field_name_;
         std::unique_ptr<Statement> rv_;
+        runtime::FieldCache cache_;
+    };
+
+    //  object.field_name = object.field_name + delta.    ,
+    //      .   FieldAssignment, . FuseSuperinstructions
+    class FieldIncrement : public Statement {
+    public:
+        FieldIncrement(VariableValue object, runtime::Symbol field_name, int delta);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        VariableValue object_;
+        runtime::Symbol field_name_;
+        int delta_;
+        runtime::FieldCache cache_;
     };
 
     //  None
@@ -78,6 +179,10 @@ namespace ast {
             [[maybe_unused]] runtime::Context& context) override {
             return {};
         }
+
+        bool EvaluateBool(runtime::Closure& /*closure*/, runtime::Context& /*context*/) override {
+            return false;
+        }
     };
 
     //  print
@@ -95,22 +200,57 @@ namespace ast {
         // context.GetOutputStream()
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
 
+        [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& GetArgs() const {
+            return args_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
         std::vector<std::unique_ptr<Statement>> args_;
     };
 
+    //  print variable:        Print
+    class PrintVariable : public Statement {
+    public:
+        explicit PrintVariable(VariableValue variable);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        VariableValue variable_;
+    };
+
     //   object.method    args
     class MethodCall : public Statement {
     public:
-        MethodCall(std::unique_ptr<Statement> object, std::string method,
+        MethodCall(std::unique_ptr<Statement> object, runtime::Symbol method,
             std::vector<std::unique_ptr<Statement>> args);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
 
+        //        
+        [[nodiscard]] const runtime::MethodCache& GetCache() const;
+
+        [[nodiscard]] Statement& GetObject() const {
+            return *object_;
+        }
+
+        [[nodiscard]] runtime::Symbol GetMethod() const {
+            return method_;
+        }
+
+        [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& GetArgs() const {
+            return args_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
         std::unique_ptr<Statement> object_;
-        std::string method_;
+        runtime::Symbol method_;
         std::vector<std::unique_ptr<Statement>> args_;
+        runtime::MethodCache cache_;
     };
 
     /*
@@ -130,12 +270,36 @@ namespace ast {
     public:
         explicit NewInstance(const runtime::Class& class_);
         NewInstance(const runtime::Class& class_, std::vector<std::unique_ptr<Statement>> args);
-        //  ,    ClassInstance
+        //    ,      Bind
+        explicit NewInstance(std::vector<std::unique_ptr<Statement>> args);
+
+        //      cls     __init__.
+        //   ,      
+        void Bind(const runtime::Class& cls);
+
+        //  ,     ClassInstance
         runtime::ObjectHolder Execute(runtime::Closure& closure, [[maybe_unused]] runtime::Context& context) override;
 
+        [[nodiscard]] const runtime::Class* GetClass() const {
+            return class_;
+        }
+
+        //     __init__  nullptr
+        [[nodiscard]] const runtime::Method* GetInit() const {
+            return init_;
+        }
+
+        [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& GetArgs() const {
+            return args_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
-        runtime::ClassInstance cls_inst_;
+        const runtime::Class* class_ = nullptr;
         std::vector<std::unique_ptr<Statement>> args_;
+        //      ,  __init__     
+        const runtime::Method* init_ = nullptr;
     };
 
     //     
@@ -145,6 +309,12 @@ namespace ast {
             : arg_(std::move(argument)) {
         }
 
+        [[nodiscard]] Statement& GetArgument() const {
+            return *arg_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     protected:
         std::unique_ptr<Statement> arg_;
     };
@@ -164,11 +334,94 @@ namespace ast {
             , rhs_(std::move(rhs)) {
         }
 
+        [[nodiscard]] Statement& GetLhs() const {
+            return *lhs_;
+        }
+
+        [[nodiscard]] Statement& GetRhs() const {
+            return *rhs_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     protected:
+        //  lhs  rhs  .      ,    lhs_number
+        //  rhs_number   true.      lhs  rhs   false
+        bool EvaluateNumbers(runtime::Closure& closure, runtime::Context& context, int& lhs_number, int& rhs_number,
+            runtime::ObjectHolder& lhs, runtime::ObjectHolder& rhs);
+
         std::unique_ptr<Statement> lhs_;
         std::unique_ptr<Statement> rhs_;
     };
 
+    /*
+     *          (quickening).
+     *  QUICKEN_THRESHOLD         .
+     *    ,       ,  
+     *   (guard)    .   ,   
+     *   ,      
+     */
+    class TypeFeedback {
+    public:
+        enum class State : std::uint8_t {
+            Warmup,
+            Numbers,    //   - 
+            Strings,    //   - 
+            Instances,  //   -   GetClass(),  -   GetMethod()
+            Generic,
+        };
+
+        struct Stats {
+            size_t numbers = 0;          // ,   
+            size_t strings = 0;          // ,   
+            size_t instances = 0;        // ,    
+            size_t deoptimizations = 0;  // ,      
+            size_t guard_hits = 0;       //   
+        };
+
+        static constexpr std::uint8_t QUICKEN_THRESHOLD = 8;
+
+        [[nodiscard]] State GetState() const {
+            return state_;
+        }
+
+        //        observed ( Instances)
+        void Record(State observed);
+        //        cls,   
+        //    method     negate. method   nullptr
+        void RecordInstance(const runtime::Class& cls, const runtime::Method* method, bool negate = false);
+
+        //  ,  lhs -  ,    ,  nullptr
+        [[nodiscard]] runtime::ClassInstance* MatchInstance(const runtime::ObjectHolder& lhs) const {
+            auto* instance = lhs.TryAs<runtime::ClassInstance>();
+            return instance != nullptr && &instance->GetClass() == cls_ ? instance : nullptr;
+        }
+        [[nodiscard]] const runtime::Method& GetMethod() const {
+            return *method_;
+        }
+        [[nodiscard]] bool IsNegated() const {
+            return negate_;
+        }
+
+        //    
+        static void Hit() {
+            ++TotalStats().guard_hits;
+        }
+        //         
+        void Deoptimize();
+
+        //     ,    
+        static Stats& TotalStats();
+
+    private:
+        State state_ = State::Warmup;
+        State observed_ = State::Warmup;
+        bool negate_ = false;
+        std::uint8_t count_ = 0;
+        const runtime::Class* cls_ = nullptr;
+        const runtime::Method* method_ = nullptr;
+    };
+
     //    +   lhs  rhs
     class Add : public BinaryOperation {
     public:
@@ -180,6 +433,14 @@ namespace ast {
         //  1 + 2,   1 -     _add__(rhs)
         //       runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        //    - ,     ObjectHolder.
+        //   ,      __add__
+        bool EvaluateInt(runtime::Closure& closure, runtime::Context& context, int& number,
+            runtime::ObjectHolder& value) override;
+
+    private:
+        TypeFeedback feedback_;
     };
 
     //     lhs  rhs
@@ -191,6 +452,9 @@ namespace ast {
         //   - 
         //  lhs  rhs -  ,   runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        bool EvaluateInt(runtime::Closure& closure, runtime::Context& context, int& number,
+            runtime::ObjectHolder& value) override;
     };
 
     //     lhs  rhs
@@ -202,6 +466,9 @@ namespace ast {
         //   * 
         //  lhs  rhs -  ,   runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        bool EvaluateInt(runtime::Closure& closure, runtime::Context& context, int& number,
+            runtime::ObjectHolder& value) override;
     };
 
     //    lhs  rhs
@@ -214,6 +481,9 @@ namespace ast {
         //  lhs  rhs -  ,   runtime_error
         //  rhs  0,   runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        bool EvaluateInt(runtime::Closure& closure, runtime::Context& context, int& number,
+            runtime::ObjectHolder& value) override;
     };
 
     //      or  lhs  rhs
@@ -223,6 +493,7 @@ namespace ast {
         //   rhs ,    lhs
         //    Bool  False
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        bool EvaluateBool(runtime::Closure& closure, runtime::Context& context) override;
     };
 
     //      and  lhs  rhs
@@ -232,6 +503,7 @@ namespace ast {
         //   rhs ,    lhs
         //    Bool  True
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        bool EvaluateBool(runtime::Closure& closure, runtime::Context& context) override;
     };
 
     //      not    
@@ -239,6 +511,7 @@ namespace ast {
     public:
         using UnaryOperation::UnaryOperation;
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        bool EvaluateBool(runtime::Closure& closure, runtime::Context& context) override;
     };
 
     //   (:  ,   if,  else)
@@ -255,9 +528,21 @@ namespace ast {
             args_.push_back(std::move(stmt));
         }
 
-        //    .  None
+        //    .  None,
+        //    return,    
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
 
+        [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& GetStatements() const {
+            return args_;
+        }
+
+        //   ,    
+        std::vector<std::unique_ptr<Statement>> TakeStatements() {
+            return std::exchange(args_, {});
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
         std::vector<std::unique_ptr<Statement>> args_;
     };
@@ -272,6 +557,12 @@ namespace ast {
         //     None
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
 
+        [[nodiscard]] Statement& GetBody() const {
+            return *body_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
         std::unique_ptr<Statement> body_;
     };
@@ -285,8 +576,15 @@ namespace ast {
 
         //    .    return ,
         //     ,      statement.
+        //       context    
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
 
+        [[nodiscard]] Statement& GetStatement() const {
+            return *statement_;
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
         std::unique_ptr<Statement> statement_;
     };
@@ -301,6 +599,11 @@ namespace ast {
         // 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
 
+        //  ,    runtime::Class
+        [[nodiscard]] const runtime::ObjectHolder& GetClass() const {
+            return cls_;
+        }
+
     private:
         runtime::ObjectHolder cls_;
     };
@@ -314,11 +617,32 @@ namespace ast {
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
 
+        [[nodiscard]] Statement& GetCondition() const {
+            return *condition_;
+        }
+
+        [[nodiscard]] Statement& GetIfBody() const {
+            return *if_body_;
+        }
+
+        //   else  nullptr,   
+        [[nodiscard]] Statement* GetElseBody() const {
+            return else_body_.get();
+        }
+
+        //  ,      condition.  else   nullptr
+        std::unique_ptr<Statement> TakeBranch(bool condition) {
+            return std::move(condition ? if_body_ : else_body_);
+        }
+
+        void ForEachChild(const ChildVisitor& visitor);
+
     private:
         std::unique_ptr<Statement> condition_, if_body_, else_body_;
     };
 
-    //  
+    //      comparator.
+    //       Compare, . MakeComparison
     class Comparison : public BinaryOperation {
     public:
         // Comparator  ,    
@@ -330,9 +654,96 @@ namespace ast {
         //    lhs  rhs     comparator,
         //    runtime::Bool
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        bool EvaluateBool(runtime::Closure& closure, runtime::Context& context) override;
 
     private:
         Comparator cmp_;
     };
 
+    //     
+    class BuiltinComparison : public BinaryOperation {
+    public:
+        [[nodiscard]] runtime::CompareOp GetOp() const {
+            return op_;
+        }
+
+    protected:
+        BuiltinComparison(runtime::CompareOp op, std::unique_ptr<Statement> lhs, std::unique_ptr<Statement> rhs)
+            : BinaryOperation(std::move(lhs), std::move(rhs))
+            , op_(op) {
+        }
+
+        //  feedback_  ,    
+        void RecordOperands(const runtime::ObjectHolder& lhs, const runtime::ObjectHolder& rhs);
+
+        TypeFeedback feedback_;
+
+    private:
+        runtime::CompareOp op_;
+    };
+
+    //   Op.    ,    
+    //    ,      EvaluateInt.
+    //    ,       (. TypeFeedback)
+    template <runtime::CompareOp Op>
+    class Compare final : public BuiltinComparison {
+    public:
+        Compare(std::unique_ptr<Statement> lhs, std::unique_ptr<Statement> rhs)
+            : BuiltinComparison(Op, std::move(lhs), std::move(rhs)) {
+        }
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override {
+            return runtime::ObjectHolder::Own(runtime::Bool(EvaluateBool(closure, context)));
+        }
+
+        bool EvaluateBool(runtime::Closure& closure, runtime::Context& context) override {
+            using State = TypeFeedback::State;
+            const State state = feedback_.GetState();
+            runtime::ObjectHolder lhs;
+            runtime::ObjectHolder rhs;
+            if (state == State::Strings || state == State::Instances) {
+                lhs = lhs_->Execute(closure, context);
+                rhs = rhs_->Execute(closure, context);
+                if (state == State::Strings) {
+                    const auto* lhs_string = lhs.TryAs<runtime::String>();
+                    const auto* rhs_string = rhs.TryAs<runtime::String>();
+                    if (lhs_string != nullptr && rhs_string != nullptr) {
+                        TypeFeedback::Hit();
+                        return runtime::CompareValues<Op>(lhs_string->GetValue(), rhs_string->GetValue());
+                    }
+                }
+                else if (runtime::ClassInstance* instance = feedback_.MatchInstance(lhs)) {
+                    TypeFeedback::Hit();
+                    const bool result = runtime::IsTrue(instance->Call(feedback_.GetMethod(), { rhs }, context));
+                    return result != feedback_.IsNegated();
+                }
+                feedback_.Deoptimize();
+                return runtime::Compare<Op>(lhs, rhs, context);
+            }
+
+            int lhs_number = 0;
+            int rhs_number = 0;
+            if (EvaluateNumbers(closure, context, lhs_number, rhs_number, lhs, rhs)) {
+                if (state == State::Numbers) {
+                    TypeFeedback::Hit();
+                }
+                else {
+                    feedback_.Record(State::Numbers);
+                }
+                return runtime::CompareValues<Op>(lhs_number, rhs_number);
+            }
+            if (state == State::Numbers) {
+                feedback_.Deoptimize();
+            }
+            else {
+                RecordOperands(lhs, rhs);
+            }
+            return runtime::Compare<Op>(lhs, rhs, context);
+        }
+    };
+
+    //    lhs  rhs  op
+    std::unique_ptr<BuiltinComparison> MakeComparison(runtime::CompareOp op, std::unique_ptr<Statement> lhs,
+        std::unique_ptr<Statement> rhs);
+
 }  // namespace ast
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "statement.h"
 #include "test_runner_p.h"
 
+#include <streambuf>
+
 using namespace std;
 
 namespace ast {
@@ -453,6 +455,191 @@ namespace ast {
             test_not(false);
         }
 
+        void TestNewInstanceCreatesFreshObjects() {
+            runtime::DummyContext context;
+            Closure closure;
+
+            // __init__  self   -,  
+            vector<runtime::Method> methods;
+            methods.push_back({ "__init__"s,
+                               {"registry"s},
+                               {make_unique<FieldAssignment>(VariableValue{"registry"s}, "last"s,
+                                                             make_unique<VariableValue>("self"s))} });
+            runtime::Class cls("Node"s, std::move(methods), nullptr);
+            runtime::Class registry_cls("Registry"s, {}, nullptr);
+
+            closure["registry"s] = ObjectHolder::Own(runtime::ClassInstance(registry_cls));
+            vector<unique_ptr<Statement>> args;
+            args.push_back(make_unique<VariableValue>("registry"s));
+            NewInstance new_instance(cls, std::move(args));
+
+            ObjectHolder first = new_instance.Execute(closure, context);
+            ObjectHolder second = new_instance.Execute(closure, context);
+            ASSERT(first.TryAs<runtime::ClassInstance>() != nullptr);
+            ASSERT(first.Get() != second.Get());
+
+            //  self      
+            auto& registry = *closure.at("registry"s).TryAs<runtime::ClassInstance>();
+            runtime::Object* last = second.Get();
+            second = ObjectHolder::None();
+            ASSERT_EQUAL(registry.Fields().at("last"s).Get(), last);
+            ASSERT(registry.Fields().at("last"s).TryAs<runtime::ClassInstance>() != nullptr);
+        }
+
+        // ,     ,    
+        class CountingContext : public runtime::Context {
+        public:
+            ostream& GetOutputStream() override {
+                return stream_;
+            }
+
+            [[nodiscard]] size_t GetPrintedCount() const {
+                return buf_.count;
+            }
+
+        private:
+            struct CountingBuf : streambuf {
+                size_t count = 0;
+
+                int_type overflow(int_type c) override {
+                    ++count;
+                    return c;
+                }
+            };
+
+            CountingBuf buf_;
+            ostream stream_{ &buf_ };
+        };
+
+        void TestPrintConstantsDoesNotAllocate() {
+            vector<unique_ptr<Statement>> args;
+            args.push_back(make_unique<NumericConst>(1));
+            args.push_back(make_unique<NumericConst>(2));
+            args.push_back(make_unique<NumericConst>(3));
+            vector<runtime::Method> methods;
+            methods.push_back({ "show"s, {}, make_unique<MethodBody>(make_unique<Print>(std::move(args))), 1 });
+            runtime::Class cls("Printer"s, std::move(methods), nullptr);
+            runtime::ClassInstance printer(cls);
+            const runtime::Method& show = *cls.GetMethod("show"s);
+
+            CountingContext context;
+            const vector<ObjectHolder> no_args;
+            printer.Call(show, no_args, context);
+
+            const size_t allocations = runtime::GetPoolAllocationCount();
+            for (int i = 0; i < 1000; ++i) {
+                printer.Call(show, no_args, context);
+            }
+
+            ASSERT_EQUAL(runtime::GetPoolAllocationCount() - allocations, 0U);
+            ASSERT_EQUAL(context.GetPrintedCount(), 1001U * "1 2 3\n"s.size());
+
+            //     
+            const ObjectHolder text = ObjectHolder::Own(runtime::String("1 2 3"s));
+            ASSERT_EQUAL(runtime::GetPoolAllocationCount() - allocations, 1U);
+        }
+
+        void TestTypedEvaluation() {
+            runtime::DummyContext context;
+            Closure closure = { {"x"s, ObjectHolder::Own(runtime::Number(4))}, {"s"s, ObjectHolder::Own(runtime::String("ab"s))} };
+
+            // (x * 3 - 2) / 5 + 1
+            Add arithmetic(make_unique<Div>(make_unique<Sub>(make_unique<Mult>(make_unique<VariableValue>("x"s),
+                make_unique<NumericConst>(3)), make_unique<NumericConst>(2)), make_unique<NumericConst>(5)),
+                make_unique<NumericConst>(1));
+            // x > 3 and not x == 5 or s < 'a'
+            Or condition(make_unique<And>(
+                MakeComparison(runtime::CompareOp::Greater, make_unique<VariableValue>("x"s), make_unique<NumericConst>(3)),
+                make_unique<Not>(MakeComparison(runtime::CompareOp::Equal, make_unique<VariableValue>("x"s),
+                    make_unique<NumericConst>(5)))),
+                MakeComparison(runtime::CompareOp::Less, make_unique<VariableValue>("s"s), make_unique<StringConst>("a"s)));
+
+            int number = 0;
+            ObjectHolder value;
+            const size_t allocations = runtime::GetPoolAllocationCount();
+            const bool is_number = arithmetic.EvaluateInt(closure, context, number, value);
+            const bool is_true = condition.EvaluateBool(closure, context);
+
+            ASSERT_EQUAL(runtime::GetPoolAllocationCount() - allocations, 0U);
+            ASSERT(is_number);
+            ASSERT_EQUAL(number, 3);
+            ASSERT(is_true);
+            ASSERT_EQUAL(arithmetic.Execute(closure, context).TryAs<runtime::Number>()->GetValue(), 3);
+
+            //      value,      Execute
+            Add strings(make_unique<VariableValue>("s"s), make_unique<StringConst>("c"s));
+            ASSERT(!strings.EvaluateInt(closure, context, number, value));
+            ASSERT_EQUAL(value.TryAs<runtime::String>()->GetValue(), "abc"s);
+            Div division(make_unique<VariableValue>("x"s), make_unique<Sub>(make_unique<NumericConst>(1),
+                make_unique<NumericConst>(1)));
+            ASSERT_THROWS(division.EvaluateInt(closure, context, number, value), runtime_error);
+            Sub mixed(make_unique<VariableValue>("x"s), make_unique<VariableValue>("s"s));
+            ASSERT_THROWS(mixed.Execute(closure, context), runtime_error);
+
+            //  comparator   
+            Comparison custom([](const ObjectHolder& lhs, const ObjectHolder& rhs, runtime::Context&) {
+                return lhs.TryAs<runtime::Number>()->GetValue() % rhs.TryAs<runtime::Number>()->GetValue() == 0;
+            }, make_unique<VariableValue>("x"s), make_unique<NumericConst>(2));
+            ASSERT(custom.EvaluateBool(closure, context));
+            ASSERT(!StringConst(runtime::String(""s)).EvaluateBool(closure, context));
+            ASSERT(!None().EvaluateBool(closure, context));
+        }
+
+        void TestQuickening() {
+            runtime::DummyContext context;
+            const TypeFeedback::Stats before = TypeFeedback::TotalStats();
+            const auto run = [&context](Statement& node, Closure& closure) {
+                ObjectHolder result;
+                for (int i = 0; i < TypeFeedback::QUICKEN_THRESHOLD * 2; ++i) {
+                    result = node.Execute(closure, context);
+                }
+                return result;
+            };
+
+            //               
+            Add addition(make_unique<VariableValue>("x"s), make_unique<VariableValue>("y"s));
+            Closure numbers = { {"x"s, ObjectHolder::Own(runtime::Number(2))}, {"y"s, ObjectHolder::Own(runtime::Number(3))} };
+            ASSERT_OBJECT_VALUE_EQUAL(run(addition, numbers), 5);
+            Closure strings = { {"x"s, ObjectHolder::Own(runtime::String("a"s))}, {"y"s, ObjectHolder::Own(runtime::String("b"s))} };
+            ASSERT_OBJECT_VALUE_EQUAL(run(addition, strings), "ab"s);
+            ASSERT_OBJECT_VALUE_EQUAL(addition.Execute(numbers, context), 5);
+
+            auto less = MakeComparison(runtime::CompareOp::Less, make_unique<VariableValue>("x"s),
+                make_unique<VariableValue>("y"s));
+            ASSERT(runtime::IsTrue(run(*less, strings)));
+
+            //       
+            auto mixed = MakeComparison(runtime::CompareOp::Equal, make_unique<VariableValue>("x"s),
+                make_unique<VariableValue>("y"s));
+            ASSERT(!runtime::IsTrue(mixed->Execute(numbers, context)));
+            ASSERT(!runtime::IsTrue(run(*mixed, strings)));
+
+            vector<runtime::Method> methods;
+            methods.push_back({ "__add__"s, {"rhs"s}, make_unique<NumericConst>(10) });
+            methods.push_back({ "__eq__"s, {"rhs"s}, make_unique<BoolConst>(runtime::Bool(true)) });
+            runtime::Class cls("Value"s, std::move(methods), nullptr);
+            vector<runtime::Method> other_methods;
+            other_methods.push_back({ "__add__"s, {"rhs"s}, make_unique<NumericConst>(20) });
+            runtime::Class other_cls("Other"s, std::move(other_methods), nullptr);
+
+            // !=    __eq__
+            Closure instances = { {"x"s, ObjectHolder::Own(runtime::ClassInstance(cls))}, {"y"s, ObjectHolder::None()} };
+            auto not_equal = MakeComparison(runtime::CompareOp::NotEqual, make_unique<VariableValue>("x"s),
+                make_unique<VariableValue>("y"s));
+            ASSERT(!runtime::IsTrue(run(*not_equal, instances)));
+            Add instance_addition(make_unique<VariableValue>("x"s), make_unique<VariableValue>("y"s));
+            ASSERT_OBJECT_VALUE_EQUAL(run(instance_addition, instances), 10);
+            Closure others = { {"x"s, ObjectHolder::Own(runtime::ClassInstance(other_cls))}, {"y"s, ObjectHolder::None()} };
+            ASSERT_OBJECT_VALUE_EQUAL(instance_addition.Execute(others, context), 20);
+
+            const TypeFeedback::Stats& after = TypeFeedback::TotalStats();
+            ASSERT_EQUAL(after.numbers - before.numbers, 1U);
+            ASSERT_EQUAL(after.strings - before.strings, 1U);
+            ASSERT_EQUAL(after.instances - before.instances, 2U);
+            ASSERT_EQUAL(after.deoptimizations - before.deoptimizations, 2U);
+            ASSERT_EQUAL(after.guard_hits - before.guard_hits, 4U * TypeFeedback::QUICKEN_THRESHOLD);
+        }
+
     }  // namespace
 
     void RunUnitTests(TestRunner& tr) {
@@ -476,6 +663,10 @@ namespace ast {
         RUN_TEST(tr, ast::TestOr);
         RUN_TEST(tr, ast::TestAnd);
         RUN_TEST(tr, ast::TestNot);
+        RUN_TEST(tr, ast::TestNewInstanceCreatesFreshObjects);
+        RUN_TEST(tr, ast::TestPrintConstantsDoesNotAllocate);
+        RUN_TEST(tr, ast::TestTypedEvaluation);
+        RUN_TEST(tr, ast::TestQuickening);
     }
 
 }  // namespace ast
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "superinstructions.h"
+
+#include "statement.h"
+
+#include <algorithm>
+#include <ostream>
+#include <string_view>
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+        //    node  counter.   EvaluateBool  EvaluateInt
+        //  ,      
+        class CountedNode : public Statement {
+        public:
+            CountedNode(unique_ptr<Statement> node, size_t& counter)
+                : node_(std::move(node))
+                , counter_(&counter) {
+            }
+
+            runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override {
+                ++*counter_;
+                return node_->Execute(closure, context);
+            }
+
+            bool EvaluateBool(runtime::Closure& closure, runtime::Context& context) override {
+                ++*counter_;
+                return node_->EvaluateBool(closure, context);
+            }
+
+            bool EvaluateInt(runtime::Closure& closure, runtime::Context& context, int& number,
+                runtime::ObjectHolder& value) override {
+                ++*counter_;
+                return node_->EvaluateInt(closure, context, number, value);
+            }
+
+            [[nodiscard]] Statement& GetNode() const {
+                return *node_;
+            }
+
+        private:
+            unique_ptr<Statement> node_;
+            size_t* counter_;
+        };
+
+        const Statement& Unwrap(const Statement& node) {
+            if (const auto* counted = dynamic_cast<const CountedNode*>(&node)) {
+                return counted->GetNode();
+            }
+            return node;
+        }
+
+        string_view ComparisonName(runtime::CompareOp op) {
+            switch (op) {
+            case runtime::CompareOp::Equal:
+                return "Equal"sv;
+            case runtime::CompareOp::NotEqual:
+                return "NotEqual"sv;
+            case runtime::CompareOp::Less:
+                return "Less"sv;
+            case runtime::CompareOp::Greater:
+                return "Greater"sv;
+            case runtime::CompareOp::LessOrEqual:
+                return "LessOrEqual"sv;
+            case runtime::CompareOp::GreaterOrEqual:
+                return "GreaterOrEqual"sv;
+            }
+            return "Comparison"sv;
+        }
+    }  // namespace
+
+    //          .   
+    //   ,      
+    class NodeRewriter {
+    public:
+        template <typename Rewrite>
+        static unique_ptr<Statement> RewriteTree(unique_ptr<Statement> node, Rewrite& rewrite) {
+            VisitChildren(*node, [&rewrite](unique_ptr<Statement>& child) {
+                child = RewriteTree(std::move(child), rewrite);
+            });
+            if (auto* p = dynamic_cast<ClassDefinition*>(node.get())) {
+                p->GetClass().TryAs<runtime::Class>()->ForEachMethodBody([&rewrite](unique_ptr<Statement>& body) {
+                    body = RewriteTree(std::move(body), rewrite);
+                });
+            }
+            return rewrite(std::move(node));
+        }
+
+        //  ,  node,   node
+        static unique_ptr<Statement> Fuse(unique_ptr<Statement> node) {
+            if (auto* p = dynamic_cast<FieldAssignment*>(node.get())) {
+                int delta = 0;
+                if (IsIncrement(*p, delta)) {
+                    return make_unique<FieldIncrement>(p->GetObject(), p->GetFieldName(), delta);
+                }
+            }
+            else if (auto* p = dynamic_cast<Print*>(node.get())) {
+                if (p->GetArgs().size() == 1) {
+                    if (const auto* variable = dynamic_cast<const VariableValue*>(p->GetArgs().front().get())) {
+                        return make_unique<PrintVariable>(*variable);
+                    }
+                }
+            }
+            return node;
+        }
+
+        //      depth  
+        static string Pattern(const Statement& wrapped, int depth) {
+            const Statement& node = Unwrap(wrapped);
+            string pattern = Name(node);
+            if (depth == 0) {
+                return pattern;
+            }
+            vector<string> children;
+            if (const auto* p = dynamic_cast<const FieldAssignment*>(&node)) {
+                children.push_back(Pattern(p->GetObject(), depth - 1));
+            }
+            VisitChildren(const_cast<Statement&>(node), [&children, depth](unique_ptr<Statement>& child) {
+                children.push_back(Pattern(*child, depth - 1));
+            });
+            if (children.empty()) {
+                return pattern;
+            }
+            pattern += '(';
+            for (size_t i = 0; i < children.size(); ++i) {
+                pattern += (i > 0 ? ", "s : ""s) + children[i];
+            }
+            pattern += ')';
+            return pattern;
+        }
+
+    private:
+        static string Name(const Statement& node) {
+            if (dynamic_cast<const NumericConst*>(&node)) {
+                return "NumericConst"s;
+            }
+            if (dynamic_cast<const StringConst*>(&node)) {
+                return "StringConst"s;
+            }
+            if (dynamic_cast<const BoolConst*>(&node)) {
+                return "BoolConst"s;
+            }
+            if (dynamic_cast<const None*>(&node)) {
+                return "None"s;
+            }
+            if (const auto* p = dynamic_cast<const VariableValue*>(&node)) {
+                return p->GetIds().size() == 1 ? "VariableValue"s : "VariableValue["s + to_string(p->GetIds().size()) + ']';
+            }
+            if (const auto* p = dynamic_cast<const BuiltinComparison*>(&node)) {
+                return string(ComparisonName(p->GetOp()));
+            }
+            static const vector<pair<string, bool (*)(const Statement&)>> names = {
+                { "Assignment"s, &Is<Assignment> },
+                { "FieldAssignment"s, &Is<FieldAssignment> },
+                { "FieldIncrement"s, &Is<FieldIncrement> },
+                { "Print"s, &Is<Print> },
+                { "PrintVariable"s, &Is<PrintVariable> },
+                { "MethodCall"s, &Is<MethodCall> },
+                { "NewInstance"s, &Is<NewInstance> },
+                { "Stringify"s, &Is<Stringify> },
+                { "Not"s, &Is<Not> },
+                { "Add"s, &Is<Add> },
+                { "Sub"s, &Is<Sub> },
+                { "Mult"s, &Is<Mult> },
+                { "Div"s, &Is<Div> },
+                { "Or"s, &Is<Or> },
+                { "And"s, &Is<And> },
+                { "Comparison"s, &Is<Comparison> },
+                { "Compound"s, &Is<Compound> },
+                { "MethodBody"s, &Is<MethodBody> },
+                { "Return"s, &Is<Return> },
+                { "ClassDefinition"s, &Is<ClassDefinition> },
+                { "IfElse"s, &Is<IfElse> },
+            };
+            for (const auto& [name, is] : names) {
+                if (is(node)) {
+                    return name;
+                }
+            }
+            return "Statement"s;
+        }
+
+        template <typename Node>
+        static bool Is(const Statement& node) {
+            return dynamic_cast<const Node*>(&node) != nullptr;
+        }
+
+        // ,  p -  object.x = object.x + k,   k  delta
+        static bool IsIncrement(FieldAssignment& p, int& delta) {
+            const auto* sum = dynamic_cast<const Add*>(&p.GetValue());
+            if (sum == nullptr) {
+                return false;
+            }
+            const auto* field = dynamic_cast<const VariableValue*>(&sum->GetLhs());
+            if (field == nullptr || dynamic_cast<const NumericConst*>(&sum->GetRhs()) == nullptr) {
+                return false;
+            }
+            const vector<runtime::Symbol>& object_ids = p.GetObject().GetIds();
+            const vector<runtime::Symbol>& field_ids = field->GetIds();
+            if (field->GetSlot() != p.GetObject().GetSlot() || field_ids.size() != object_ids.size() + 1
+                || !equal(object_ids.begin(), object_ids.end(), field_ids.begin())
+                || field_ids.back() != p.GetFieldName()) {
+                return false;
+            }
+            //     closure  context
+            runtime::Closure closure;
+            runtime::DummyContext context;
+            runtime::ObjectHolder value;
+            return sum->GetRhs().EvaluateInt(closure, context, delta, value);
+        }
+    };
+
+    unique_ptr<runtime::Executable> FuseSuperinstructions(unique_ptr<runtime::Executable> program) {
+        const auto fuse = [](unique_ptr<Statement> node) {
+            return NodeRewriter::Fuse(std::move(node));
+        };
+        return NodeRewriter::RewriteTree(std::move(program), fuse);
+    }
+
+    unique_ptr<runtime::Executable> NodeProfile::Instrument(unique_ptr<runtime::Executable> program) {
+        const auto count = [this](unique_ptr<Statement> node) -> unique_ptr<Statement> {
+            //   ,     
+            size_t& counter = counts_[NodeRewriter::Pattern(*node, 2)];
+            return make_unique<CountedNode>(std::move(node), counter);
+        };
+        return NodeRewriter::RewriteTree(std::move(program), count);
+    }
+
+    vector<pair<string, size_t>> NodeProfile::GetPatterns() const {
+        vector<pair<string, size_t>> patterns(counts_.begin(), counts_.end());
+        sort(patterns.begin(), patterns.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+        });
+        return patterns;
+    }
+
+    void NodeProfile::Report(ostream& out, size_t limit) const {
+        const auto patterns = GetPatterns();
+        out << "Node patterns by executions:"sv << endl;
+        for (size_t i = 0; i < min(limit, patterns.size()); ++i) {
+            out << patterns[i].second << '\t' << patterns[i].first << endl;
+        }
+    }
+
+}  // namespace ast
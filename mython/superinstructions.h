@@ -0,0 +1,47 @@
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace runtime {
+    class Executable;
+}
+
+namespace ast {
+
+    /*
+     *      -,      Execute:
+     *  object.x = object.x + k,  k -  ,   FieldIncrement;
+     *  print      PrintVariable.
+     *     NodeProfile.         .
+     *     ,        
+     *       
+     */
+    std::unique_ptr<runtime::Executable> FuseSuperinstructions(std::unique_ptr<runtime::Executable> program);
+
+    /*
+     *     .  -       
+     *    ,  FieldAssignment(VariableValue, Add(VariableValue[2], NumericConst)).
+     *       VariableValue[< >]
+     */
+    class NodeProfile {
+    public:
+        //    program,   ,    .
+        //   ,    
+        std::unique_ptr<runtime::Executable> Instrument(std::unique_ptr<runtime::Executable> program);
+
+        //          
+        [[nodiscard]] std::vector<std::pair<std::string, size_t>> GetPatterns() const;
+
+        //    limit   
+        void Report(std::ostream& out, size_t limit) const;
+
+    private:
+        std::unordered_map<std::string, size_t> counts_;
+    };
+
+}  // namespace ast
@@ -0,0 +1,132 @@
+#include "lexer.h"
+#include "parse.h"
+#include "statement.h"
+#include "superinstructions.h"
+#include "test_runner_p.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+
+        unique_ptr<Statement> Parse(const string& program) {
+            istringstream input(program);
+            parse::Lexer lexer(input);
+            return ParseProgram(lexer);
+        }
+
+        string Run(Statement& program) {
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            program.Execute(closure, context);
+            return context.output.str();
+        }
+
+        size_t Executions(const NodeProfile& profile, const string& pattern) {
+            const auto patterns = profile.GetPatterns();
+            const auto it = find_if(patterns.begin(), patterns.end(), [&pattern](const auto& entry) {
+                return entry.first == pattern;
+            });
+            return it == patterns.end() ? 0 : it->second;
+        }
+
+        const string COUNTER_PROGRAM = R"(
+class Counter:
+  def __init__():
+    self.count = 0
+    self.total = 'x'
+
+  def run(n):
+    if n > 0:
+      self.count = self.count + 2
+      self.total = self.total + str(n)
+      return self.run(n - 1)
+    return self.count
+
+counter = Counter()
+result = counter.run(5)
+print result
+print counter.count, counter.total
+)"s;
+
+        void TestIdiomsAreFused() {
+            ASSERT_EQUAL(Run(*Parse(COUNTER_PROGRAM)), "10\n10 x54321\n"s);
+
+            NodeProfile profile;
+            auto fused = profile.Instrument(FuseSuperinstructions(Parse(COUNTER_PROGRAM)));
+            ASSERT_EQUAL(Run(*fused), "10\n10 x54321\n"s);
+
+            ASSERT_EQUAL(Executions(profile, "FieldIncrement"s), 5U);
+            ASSERT_EQUAL(Executions(profile, "PrintVariable"s), 1U);
+            //    
+            ASSERT_EQUAL(Executions(profile,
+                "FieldAssignment(VariableValue, Add(VariableValue[2], Stringify))"s), 5U);
+            ASSERT_EQUAL(Executions(profile, "Print(VariableValue[2], VariableValue[2])"s), 1U);
+        }
+
+        void TestProfileFindsIdioms() {
+            NodeProfile profile;
+            auto program = profile.Instrument(Parse(COUNTER_PROGRAM));
+            ASSERT_EQUAL(Run(*program), "10\n10 x54321\n"s);
+
+            ASSERT_EQUAL(Executions(profile, "FieldAssignment(VariableValue, Add(VariableValue[2], NumericConst))"s), 5U);
+            ASSERT_EQUAL(Executions(profile, "Print(VariableValue)"s), 1U);
+            ASSERT_EQUAL(Executions(profile, "Greater(VariableValue, NumericConst)"s), 6U);
+
+            const auto patterns = profile.GetPatterns();
+            ASSERT(!patterns.empty());
+            ASSERT(is_sorted(patterns.begin(), patterns.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.second > rhs.second;
+            }));
+
+            ostringstream report;
+            profile.Report(report, 3);
+            const string text = report.str();
+            ASSERT_EQUAL(count(text.begin(), text.end(), '\n'), 4);
+        }
+
+        void TestFieldIncrementMatchesFieldAssignment() {
+            vector<runtime::Method> methods;
+            methods.push_back({ "__add__"s, {"rhs"s}, make_unique<VariableValue>("rhs"s) });
+            runtime::Class cls("Value"s, std::move(methods), nullptr);
+
+            runtime::DummyContext context;
+            runtime::ObjectHolder object = runtime::ObjectHolder::Own(runtime::ClassInstance(cls));
+            runtime::Closure closure = { {"p"s, object}, {"n"s, runtime::ObjectHolder::Own(runtime::Number(1))} };
+            auto& fields = object.TryAs<runtime::ClassInstance>()->Fields();
+            const auto increment = [](const string& field) {
+                return FuseSuperinstructions(make_unique<FieldAssignment>(VariableValue("p"s), field,
+                    make_unique<Add>(make_unique<VariableValue>(vector{ "p"s, field }), make_unique<NumericConst>(3))));
+            };
+
+            fields["number"s] = runtime::ObjectHolder::Own(runtime::Number(4));
+            ASSERT_EQUAL(increment("number"s)->Execute(closure, context).TryAs<runtime::Number>()->GetValue(), 7);
+            ASSERT_EQUAL(fields["number"s].TryAs<runtime::Number>()->GetValue(), 7);
+
+            // -   __add__
+            fields["object"s] = runtime::ObjectHolder::Own(runtime::ClassInstance(cls));
+            increment("object"s)->Execute(closure, context);
+            ASSERT_EQUAL(fields["object"s].TryAs<runtime::Number>()->GetValue(), 3);
+
+            fields["string"s] = runtime::ObjectHolder::Own(runtime::String("a"s));
+            ASSERT_THROWS(increment("string"s)->Execute(closure, context), runtime_error);
+            ASSERT_THROWS(increment("missing"s)->Execute(closure, context), runtime_error);
+            ASSERT_EQUAL(fields.count("missing"s), 0U);
+
+            auto non_object = FuseSuperinstructions(make_unique<FieldAssignment>(VariableValue("n"s), "x"s,
+                make_unique<Add>(make_unique<VariableValue>(vector{ "n"s, "x"s }), make_unique<NumericConst>(1))));
+            ASSERT_THROWS(non_object->Execute(closure, context), runtime_error);
+        }
+
+    }  // namespace
+
+    void RunSuperinstructionTests(TestRunner& tr) {
+        RUN_TEST(tr, ast::TestIdiomsAreFused);
+        RUN_TEST(tr, ast::TestProfileFindsIdioms);
+        RUN_TEST(tr, ast::TestFieldIncrementMatchesFieldAssignment);
+    }
+
+}  // namespace ast
@@ -0,0 +1,72 @@
+#include "symbol.h"
+
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace runtime {
+
+    struct Symbol::Table {
+        shared_mutex mutex;
+        //  deque    ,       
+        deque<Entry> entries;
+        unordered_map<string_view, const Entry*> index;
+    };
+
+    Symbol::Table& Symbol::GetTable() {
+        //    ,    
+        //    
+        static auto* table = new Table();
+        return *table;
+    }
+
+    const Symbol::Entry* Symbol::Intern(string_view name) {
+        Table& table = GetTable();
+        {
+            shared_lock lock(table.mutex);
+            if (auto it = table.index.find(name); it != table.index.end()) {
+                return it->second;
+            }
+        }
+        unique_lock lock(table.mutex);
+        //    ,     
+        if (auto it = table.index.find(name); it != table.index.end()) {
+            return it->second;
+        }
+        const Entry& entry = table.entries.emplace_back(Entry{ string(name), static_cast<uint32_t>(table.entries.size()) });
+        table.index.emplace(entry.name, &entry);
+        return &entry;
+    }
+
+    Symbol::Symbol() {
+        static const Entry* const empty = Intern({});
+        entry_ = empty;
+    }
+
+    Symbol::Symbol(string_view name)
+        : entry_(Intern(name)) {
+    }
+
+    Symbol::Symbol(const string& name)
+        : entry_(Intern(name)) {
+    }
+
+    Symbol::Symbol(const char* name)
+        : entry_(Intern(name)) {
+    }
+
+    size_t Symbol::GetCount() {
+        Table& table = GetTable();
+        shared_lock lock(table.mutex);
+        return table.entries.size();
+    }
+
+    ostream& operator<<(ostream& os, Symbol symbol) {
+        return os << symbol.GetName();
+    }
+
+}  // namespace runtime
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace runtime {
+
+    /*
+     *  (,    ),       .
+     *        ,   
+     *     .       
+     */
+    class Symbol {
+    public:
+        //    
+        Symbol();
+        Symbol(std::string_view name);    // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        Symbol(const std::string& name);  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        Symbol(const char* name);         // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+
+        //   .      
+        [[nodiscard]] std::uint32_t GetId() const {
+            return entry_->id;
+        }
+
+        [[nodiscard]] const std::string& GetName() const {
+            return entry_->name;
+        }
+
+        friend bool operator==(Symbol lhs, Symbol rhs) {
+            return lhs.entry_ == rhs.entry_;
+        }
+
+        friend bool operator!=(Symbol lhs, Symbol rhs) {
+            return lhs.entry_ != rhs.entry_;
+        }
+
+        //    
+        static std::size_t GetCount();
+
+    private:
+        struct Entry {
+            std::string name;
+            std::uint32_t id;
+        };
+
+        struct Table;
+
+        static Table& GetTable();
+        static const Entry* Intern(std::string_view name);
+
+        const Entry* entry_;
+    };
+
+    std::ostream& operator<<(std::ostream& os, Symbol symbol);
+
+}  // namespace runtime
+
+template <>
+struct std::hash<runtime::Symbol> {
+    std::size_t operator()(runtime::Symbol symbol) const noexcept {
+        return symbol.GetId();
+    }
+};